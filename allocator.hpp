@@ -1,6 +1,15 @@
 #pragma once
 
 #include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <bit>
+#include <type_traits>
+#include "altraits.hpp"
+#include <sys/mman.h>
 
 template <typename ValueType>
 class Allocator {
@@ -17,16 +26,702 @@ public:
 
     Allocator() = default;
 
+    // throws std::bad_alloc when the memory can't be had, n*sizeof(ValueType) overflowing included
+    Pointer allocate(SizeType n) {
+        if (n == 0) return nullptr;
+        if (n > SIZE_MAX / sizeof(ValueType)) throw std::bad_alloc();
+        Pointer ptr = static_cast<Pointer>(malloc(n*sizeof(ValueType)));
+        if (!ptr) throw std::bad_alloc();
+        return ptr;
+    }
+
+    void deallocate(Pointer ptr, SizeType n) {
+        free(ptr);
+    }
+
+    // glibc serves big blocks with mmap and grows them with mremap, so this doesn't copy them;
+    // on failure ptr stays valid and std::bad_alloc is thrown
+    Pointer reallocate(Pointer ptr, SizeType /*n*/, SizeType new_n) {
+        // realloc(ptr, 0) would free ptr, leave shrinking to nothing to the caller
+        if (new_n == 0) return nullptr;
+        if (new_n > SIZE_MAX / sizeof(ValueType)) throw std::bad_alloc();
+        Pointer res = static_cast<Pointer>(realloc(ptr, new_n*sizeof(ValueType)));
+        if (!res) throw std::bad_alloc();
+        return res;
+    }
+
+};
+
+// Allocator that serves single-object requests from slabs of SlabSize bytes.
+// Freed objects go to a free list and are reused by the next allocate(1),
+// slabs themselves are returned only when the last copy of the allocator dies.
+// Copies share one pool; requests for n != 1 objects fall back to malloc.
+template <typename ValueType, size_t SlabSize = 4096>
+class PoolAllocator {
+public:
+    using Pointer           = ValueType*;
+    using Reference         = ValueType&;
+    using ConstPointer      = const ValueType*;
+    using ConstReference    = const ValueType&;
+    using SizeType          = size_t;
+    using DiffType          = int;
+
+    template<typename T>
+    using RebindAlloc       = PoolAllocator<T, SlabSize>;
+
+    PoolAllocator() : pool(new Pool{nullptr, nullptr, 1}) {}
+
+    PoolAllocator(const PoolAllocator& other) : pool(other.pool) {
+        ++pool->refs;
+    }
+
+    PoolAllocator& operator=(const PoolAllocator& other) {
+        if (pool != other.pool) {
+            release();
+            pool = other.pool;
+            ++pool->refs;
+        }
+        return *this;
+    }
+
+    ~PoolAllocator() {
+        release();
+    }
+
+    Pointer allocate(SizeType n) {
+        if (n == 0) {
+            return nullptr;
+        } else if (n != 1) {
+            if (n > SIZE_MAX / sizeof(ValueType)) throw std::bad_alloc();
+            Pointer ptr = static_cast<Pointer>(malloc(n*sizeof(ValueType)));
+            if (!ptr) throw std::bad_alloc();
+            return ptr;
+        } else {
+            if (!pool->free) grow();
+            Block* block = pool->free;
+            pool->free = block->next;
+            return reinterpret_cast<Pointer>(block);
+        }
+    }
+
+    void deallocate(Pointer ptr, SizeType n) {
+        if (!ptr) {
+            return;
+        } else if (n != 1) {
+            free(ptr);
+        } else {
+            Block* block = reinterpret_cast<Block*>(ptr);
+            block->next = pool->free;
+            pool->free = block;
+        }
+    }
+
+private:
+    union Block {
+        Block* next;
+        alignas(ValueType) unsigned char storage[sizeof(ValueType)];
+    };
+
+    struct Slab {
+        Slab* next;
+    };
+
+    struct Pool {
+        Block* free;
+        Slab* slabs;
+        SizeType refs;
+    };
+
+    static_assert(alignof(Block) <= alignof(std::max_align_t), "PoolAllocator doesn't support over-aligned types");
+
+    // blocks are placed right after the slab header, padded to the block alignment
+    static constexpr SizeType header_size = (sizeof(Slab) + alignof(Block) - 1) / alignof(Block) * alignof(Block);
+    static constexpr SizeType blocks_per_slab = (SlabSize > header_size + sizeof(Block) ?
+                                                    (SlabSize - header_size) / sizeof(Block) : 1);
+
+    void grow() {
+        Slab* slab = static_cast<Slab*>(malloc(header_size + blocks_per_slab*sizeof(Block)));
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        Block* blocks = reinterpret_cast<Block*>(reinterpret_cast<unsigned char*>(slab) + header_size);
+        for (SizeType i = blocks_per_slab; i > 0; --i) {
+            blocks[i - 1].next = pool->free;
+            pool->free = blocks + i - 1;
+        }
+    }
+
+    void release() {
+        if (--pool->refs == 0) {
+            while (pool->slabs) {
+                Slab* next = pool->slabs->next;
+                free(pool->slabs);
+                pool->slabs = next;
+            }
+            delete pool;
+        }
+    }
+
+    Pool* pool;
+};
+
+// State shared by all copies of an ArenaAllocator, whatever type they are rebound to
+struct Arena {
+    struct Chunk {
+        Chunk* next;
+    };
+
+    Chunk* chunks;
+    unsigned char* cur;
+    unsigned char* end;
+    size_t refs;
+};
+
+// Monotonic allocator: bump-allocates from chunks of ChunkSize bytes and never
+// frees individual objects, deallocate is a no-op. All memory is released at once
+// by reset() or when the last copy of the allocator dies, so containers using it
+// must not outlive the arena. Copies and rebound copies share one arena.
+template <typename ValueType, size_t ChunkSize = 65536>
+class ArenaAllocator {
+public:
+    using Pointer           = ValueType*;
+    using Reference         = ValueType&;
+    using ConstPointer      = const ValueType*;
+    using ConstReference    = const ValueType&;
+    using SizeType          = size_t;
+    using DiffType          = int;
+
+    template<typename T>
+    using RebindAlloc       = ArenaAllocator<T, ChunkSize>;
+
+    template <typename T, size_t CS>
+    friend class ArenaAllocator;
+
+    static constexpr bool is_monotonic = true;
+
+    ArenaAllocator() : arena(new Arena{nullptr, nullptr, nullptr, 1}) {}
+
+    ArenaAllocator(const ArenaAllocator& other) : arena(other.arena) {
+        ++arena->refs;
+    }
+
+    template <typename T>
+    ArenaAllocator(const ArenaAllocator<T, ChunkSize>& other) : arena(other.arena) {
+        ++arena->refs;
+    }
+
+    ArenaAllocator& operator=(const ArenaAllocator& other) {
+        if (arena != other.arena) {
+            release();
+            arena = other.arena;
+            ++arena->refs;
+        }
+        return *this;
+    }
+
+    ~ArenaAllocator() {
+        release();
+    }
+
+    Pointer allocate(SizeType n) {
+        if (n == 0) return nullptr;
+        SizeType bytes = n*sizeof(ValueType);
+        unsigned char* ptr = align(arena->cur);
+        if (!ptr || ptr + bytes > arena->end) {
+            grow(bytes);
+            ptr = align(arena->cur);
+        }
+        arena->cur = ptr + bytes;
+        return reinterpret_cast<Pointer>(ptr);
+    }
+
+    void deallocate(Pointer ptr, SizeType n) {}
+
+    // the most recent allocation can grow while the chunk has room
+    bool expand(Pointer ptr, SizeType n, SizeType new_n) {
+        unsigned char* begin = reinterpret_cast<unsigned char*>(ptr);
+        if (begin + n*sizeof(ValueType) != arena->cur || begin + new_n*sizeof(ValueType) > arena->end) {
+            return false;
+        }
+        arena->cur = begin + new_n*sizeof(ValueType);
+        return true;
+    }
+
+    // frees every chunk; everything allocated from this arena becomes invalid
+    void reset() {
+        while (arena->chunks) {
+            Arena::Chunk* next = arena->chunks->next;
+            free(arena->chunks);
+            arena->chunks = next;
+        }
+        arena->cur = arena->end = nullptr;
+    }
+
+private:
+    static_assert(alignof(ValueType) <= alignof(std::max_align_t), "ArenaAllocator doesn't support over-aligned types");
+
+    static unsigned char* align(unsigned char* ptr) {
+        if (!ptr) return nullptr;
+        SizeType mis = reinterpret_cast<size_t>(ptr) % alignof(ValueType);
+        return mis ? ptr + (alignof(ValueType) - mis) : ptr;
+    }
+
+    void grow(SizeType bytes) {
+        SizeType size = sizeof(std::max_align_t) + bytes;
+        if (size < ChunkSize) size = ChunkSize;
+        Arena::Chunk* chunk = static_cast<Arena::Chunk*>(malloc(size));
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+        arena->cur = reinterpret_cast<unsigned char*>(chunk) + sizeof(std::max_align_t);
+        arena->end = reinterpret_cast<unsigned char*>(chunk) + size;
+    }
+
+    void release() {
+        if (--arena->refs == 0) {
+            reset();
+            delete arena;
+        }
+    }
+
+    Arena* arena;
+};
+
+// Size-class free lists behind ThreadCachingAllocator. Every thread keeps its own
+// lists and touches the shared depot (under a per-class mutex) only to refill an
+// empty list or to hand back what exceeds cache_limit, batch_size blocks at a time.
+// Blocks are carved from slabs that stay with the process; bigger requests go to malloc.
+class ThreadCache {
+public:
+    static constexpr size_t granularity = 16;
+    static constexpr size_t class_count = 32;
+    static constexpr size_t max_size = granularity*class_count;
+    static constexpr size_t batch_size = 32;
+    static constexpr size_t cache_limit = 32768;    // bytes a thread may hold per size class
+
+    static void* allocate(size_t bytes) {
+        if (bytes > max_size) return malloc(bytes);
+        size_t cls = SizeClass(bytes);
+        Bin& bin = Local().bins[cls];
+        if (!bin.head) Refill(bin, cls);
+        Block* block = bin.head;
+        bin.head = block->next;
+        --bin.count;
+        return block;
+    }
+
+    static void deallocate(void* ptr, size_t bytes) {
+        if (!ptr) {
+            return;
+        } else if (bytes > max_size) {
+            free(ptr);
+        } else {
+            size_t cls = SizeClass(bytes);
+            Bin& bin = Local().bins[cls];
+            Block* block = static_cast<Block*>(ptr);
+            block->next = bin.head;
+            bin.head = block;
+            ++bin.count;
+            if (bin.count*ClassSize(cls) > cache_limit) Flush(bin, cls, batch_size);
+        }
+    }
+
+private:
+    struct Block {
+        Block* next;
+    };
+
+    struct Bin {
+        Block* head = nullptr;
+        size_t count = 0;
+    };
+
+    struct Cache {
+        Bin bins[class_count];
+        ~Cache() {
+            for (size_t cls = 0; cls < class_count; ++cls) {
+                Flush(bins[cls], cls, bins[cls].count);
+            }
+        }
+    };
+
+    struct Depot {
+        std::mutex lock;
+        Block* head = nullptr;
+    };
+
+    static size_t SizeClass(size_t bytes) noexcept {
+        return bytes == 0 ? 0 : (bytes - 1)/granularity;
+    }
+
+    static size_t ClassSize(size_t cls) noexcept {
+        return (cls + 1)*granularity;
+    }
+
+    static Cache& Local() {
+        thread_local Cache cache;
+        return cache;
+    }
+
+    static Depot* Depots() {
+        // never destroyed: thread caches may flush into it during program exit
+        static Depot* depots = new Depot[class_count];
+        return depots;
+    }
+
+    static void Refill(Bin& bin, size_t cls) {
+        Depot& depot = Depots()[cls];
+        {
+            std::lock_guard<std::mutex> guard(depot.lock);
+            while (depot.head && bin.count < batch_size) {
+                Block* block = depot.head;
+                depot.head = block->next;
+                block->next = bin.head;
+                bin.head = block;
+                ++bin.count;
+            }
+        }
+        if (!bin.head) {
+            unsigned char* slab = static_cast<unsigned char*>(malloc(batch_size*ClassSize(cls)));
+            for (size_t i = batch_size; i > 0; --i) {
+                Block* block = reinterpret_cast<Block*>(slab + (i - 1)*ClassSize(cls));
+                block->next = bin.head;
+                bin.head = block;
+            }
+            bin.count = batch_size;
+        }
+    }
+
+    static void Flush(Bin& bin, size_t cls, size_t n) {
+        if (n == 0) return;
+        Block* first = bin.head, *last = bin.head;
+        for (size_t i = 1; i < n; ++i) last = last->next;
+        bin.head = last->next;
+        bin.count -= n;
+        Depot& depot = Depots()[cls];
+        std::lock_guard<std::mutex> guard(depot.lock);
+        last->next = depot.head;
+        depot.head = first;
+    }
+};
+
+// Stateless allocator working through the calling thread's ThreadCache
+template <typename ValueType>
+class ThreadCachingAllocator {
+public:
+    using Pointer           = ValueType*;
+    using Reference         = ValueType&;
+    using ConstPointer      = const ValueType*;
+    using ConstReference    = const ValueType&;
+    using SizeType          = size_t;
+    using DiffType          = int;
+
+    template<typename T>
+    using RebindAlloc       = ThreadCachingAllocator<T>;
+
+    ThreadCachingAllocator() = default;
+
     Pointer allocate(SizeType n) {
         if (n == 0) {
             return nullptr;
         } else {
-            return static_cast<Pointer>(malloc(n*sizeof(ValueType)));
+            if (n > SIZE_MAX / sizeof(ValueType)) throw std::bad_alloc();
+            return static_cast<Pointer>(ThreadCache::allocate(n*sizeof(ValueType)));
         }
     }
 
     void deallocate(Pointer ptr, SizeType n) {
-        delete[] ptr;
+        ThreadCache::deallocate(ptr, n*sizeof(ValueType));
+    }
+
+private:
+    static_assert(alignof(ValueType) <= ThreadCache::granularity, "ThreadCachingAllocator doesn't support over-aligned types");
+};
+
+// Allocation counters shared by every StatsAllocator with the same Tag.
+// Updates use relaxed atomics, so the numbers are exact once the threads
+// touching them are done and approximate while they are running.
+class AllocationStats {
+public:
+    static constexpr size_t histogram_size = 32;    // bucket i counts requests of [2^(i-1), 2^i) bytes
+
+    template <typename Tag>
+    static AllocationStats& of() noexcept {
+        static AllocationStats stats;
+        return stats;
+    }
+
+    size_t allocations() const noexcept {
+        return _allocations.load(std::memory_order_relaxed);
+    }
+    size_t deallocations() const noexcept {
+        return _deallocations.load(std::memory_order_relaxed);
+    }
+    size_t total_bytes() const noexcept {
+        return _total_bytes.load(std::memory_order_relaxed);
+    }
+    size_t live_bytes() const noexcept {
+        return _live_bytes.load(std::memory_order_relaxed);
+    }
+    size_t peak_bytes() const noexcept {
+        return _peak_bytes.load(std::memory_order_relaxed);
+    }
+    size_t histogram(size_t bucket) const noexcept {
+        return bucket < histogram_size ? _histogram[bucket].load(std::memory_order_relaxed) : 0;
+    }
+
+    void reset() noexcept {
+        _allocations.store(0, std::memory_order_relaxed);
+        _deallocations.store(0, std::memory_order_relaxed);
+        _total_bytes.store(0, std::memory_order_relaxed);
+        _peak_bytes.store(_live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        for (auto& bucket : _histogram) bucket.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    template <typename Inner, typename Tag>
+    friend class StatsAllocator;
+
+    void Allocated(size_t bytes) noexcept {
+        _allocations.fetch_add(1, std::memory_order_relaxed);
+        _total_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        size_t live = _live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        size_t peak = _peak_bytes.load(std::memory_order_relaxed);
+        while (live > peak && !_peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        size_t bucket = std::bit_width(bytes);
+        _histogram[bucket < histogram_size ? bucket : histogram_size - 1].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Deallocated(size_t bytes) noexcept {
+        _deallocations.fetch_add(1, std::memory_order_relaxed);
+        _live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    std::atomic<size_t> _allocations{}, _deallocations{}, _total_bytes{}, _live_bytes{}, _peak_bytes{};
+    std::atomic<size_t> _histogram[histogram_size]{};
+};
+
+// Adapter that forwards to Inner and records every request in AllocationStats::of<Tag>().
+// Rebinding keeps the tag, so a container's node and value allocations are counted together:
+//     Set<int, Less<int>, StatsAllocator<Allocator<int>, struct SessionSet>> sessions;
+//     AllocationStats::of<SessionSet>().peak_bytes();
+template <typename Inner, typename Tag = void>
+class StatsAllocator {
+public:
+    using ValueType         = std::remove_pointer_t<typename Inner::Pointer>;
+    using Pointer           = typename Inner::Pointer;
+    using Reference         = ValueType&;
+    using ConstPointer      = const ValueType*;
+    using ConstReference    = const ValueType&;
+    using SizeType          = typename Inner::SizeType;
+    using DiffType          = int;
+
+    template<typename T>
+    using RebindAlloc       = StatsAllocator<typename Inner::template RebindAlloc<T>, Tag>;
+
+    StatsAllocator() = default;
+    StatsAllocator(const Inner& inner) : inner(inner) {}
+
+    static AllocationStats& stats() noexcept {
+        return AllocationStats::of<Tag>();
+    }
+
+    Pointer allocate(SizeType n) {
+        Pointer ptr = inner.allocate(n);
+        if (ptr) stats().Allocated(n*sizeof(ValueType));
+        return ptr;
+    }
+
+    void deallocate(Pointer ptr, SizeType n) {
+        if (ptr) stats().Deallocated(n*sizeof(ValueType));
+        inner.deallocate(ptr, n);
+    }
+
+    bool expand(Pointer ptr, SizeType n, SizeType new_n) requires AllocatorTraits<ValueType, Inner>::can_expand {
+        if (!inner.expand(ptr, n, new_n)) return false;
+        stats().Deallocated(n*sizeof(ValueType));
+        stats().Allocated(new_n*sizeof(ValueType));
+        return true;
+    }
+
+    Pointer reallocate(Pointer ptr, SizeType n, SizeType new_n) requires AllocatorTraits<ValueType, Inner>::can_reallocate {
+        Pointer newptr = inner.reallocate(ptr, n, new_n);
+        if (newptr) {
+            stats().Deallocated(n*sizeof(ValueType));
+            stats().Allocated(new_n*sizeof(ValueType));
+        }
+        return newptr;
+    }
+
+private:
+    Inner inner;
+};
+
+// Allocator returning Alignment-aligned blocks (64 bytes by default: a cache line,
+// enough for AVX-512 loads). Blocks of at least HugeThreshold bytes are mapped
+// directly, aligned to 2 MiB and advised to use transparent huge pages; on Linux
+// such blocks grow with mremap instead of being copied.
+template <typename ValueType, size_t Alignment = 64, size_t HugeThreshold = (size_t(1) << 21)>
+class AlignedAllocator {
+public:
+    using Pointer           = ValueType*;
+    using Reference         = ValueType&;
+    using ConstPointer      = const ValueType*;
+    using ConstReference    = const ValueType&;
+    using SizeType          = size_t;
+    using DiffType          = int;
+
+    template<typename T>
+    using RebindAlloc       = AlignedAllocator<T, Alignment, HugeThreshold>;
+
+    static constexpr SizeType alignment = Alignment;
+    static constexpr SizeType huge_page_size = SizeType(1) << 21;
+
+    AlignedAllocator() = default;
+
+    Pointer allocate(SizeType n) {
+        if (n == 0) {
+            return nullptr;
+        } else if (n > (SIZE_MAX - huge_page_size) / sizeof(ValueType)) {
+            throw std::bad_alloc();
+        }
+        void* ptr = (IsHuge(n) ? MapHuge(MappedSize(n)) : aligned_alloc(Alignment, RoundUp(n*sizeof(ValueType), Alignment)));
+        if (!ptr) throw std::bad_alloc();
+        return static_cast<Pointer>(ptr);
+    }
+
+    void deallocate(Pointer ptr, SizeType n) {
+        if (!ptr) {
+            return;
+        } else if (IsHuge(n)) {
+            munmap(ptr, MappedSize(n));
+        } else {
+            free(ptr);
+        }
+    }
+
+    bool expand(Pointer ptr, SizeType n, SizeType new_n) {
+#ifdef __linux__
+        if (!IsHuge(n) || !IsHuge(new_n)) return false;
+        return mremap(ptr, MappedSize(n), MappedSize(new_n), 0) != MAP_FAILED;
+#else
+        return false;
+#endif
+    }
+
+    Pointer reallocate(Pointer ptr, SizeType n, SizeType new_n) {
+#ifdef __linux__
+        if (!IsHuge(n) || !IsHuge(new_n)) return nullptr;
+        SizeType size = MappedSize(n), new_size = MappedSize(new_n);
+        if (mremap(ptr, size, new_size, 0) != MAP_FAILED) return ptr;
+        // mremap may move the pages anywhere page aligned, so map an aligned destination first
+        void* dst = MapHuge(new_size);
+        if (!dst) return nullptr;
+        void* res = mremap(ptr, size, new_size, MREMAP_MAYMOVE | MREMAP_FIXED, dst);
+        if (res == MAP_FAILED) {
+            munmap(dst, new_size);
+            return nullptr;
+        }
+        return static_cast<Pointer>(res);
+#else
+        return nullptr;
+#endif
+    }
+
+private:
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(ValueType), "Alignment is weaker than the type requires");
+    static_assert(Alignment <= huge_page_size, "Alignment can't exceed the huge page size");
+
+    static constexpr SizeType RoundUp(SizeType bytes, SizeType to) noexcept {
+        return (bytes + to - 1) / to * to;
+    }
+
+    static constexpr bool IsHuge(SizeType n) noexcept {
+        return n*sizeof(ValueType) >= HugeThreshold;
+    }
+
+    static constexpr SizeType MappedSize(SizeType n) noexcept {
+        return RoundUp(n*sizeof(ValueType), huge_page_size);
+    }
+
+    static void* MapHuge(SizeType size) {
+        // map one extra huge page and trim both ends, so the block starts on a huge page boundary
+        void* raw = mmap(nullptr, size + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) return nullptr;
+        unsigned char* begin = static_cast<unsigned char*>(raw);
+        unsigned char* aligned = reinterpret_cast<unsigned char*>(RoundUp(reinterpret_cast<size_t>(begin), huge_page_size));
+        if (aligned != begin) munmap(begin, aligned - begin);
+        munmap(aligned + size, begin + huge_page_size - aligned);
+#ifdef MADV_HUGEPAGE
+        madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+        return aligned;
+    }
+};
+
+// Allocator with room for N objects inside itself: the first request of at most N
+// objects is served from that buffer, everything else goes to Fallback. Copies get
+// their own empty buffer, so memory never moves along with the allocator; this suits
+// Array (see SmallArray), but not node containers that swap allocators on move.
+template <typename ValueType, size_t N, TAllocator Fallback = Allocator<ValueType>>
+class InlineAllocator {
+public:
+    using Pointer           = ValueType*;
+    using Reference         = ValueType&;
+    using ConstPointer      = const ValueType*;
+    using ConstReference    = const ValueType&;
+    using SizeType          = size_t;
+    using DiffType          = int;
+
+    template<typename T>
+    using RebindAlloc       = InlineAllocator<T, N, typename Fallback::template RebindAlloc<T>>;
+
+    static constexpr SizeType inline_capacity = N;
+
+    InlineAllocator() : used(false), fallback() {}
+    InlineAllocator(const InlineAllocator& other) : used(false), fallback(other.fallback) {}
+
+    InlineAllocator& operator=(const InlineAllocator& other) {
+        fallback = other.fallback;
+        return *this;
+    }
+
+    bool owns(ConstPointer ptr) const noexcept {
+        return ptr == reinterpret_cast<ConstPointer>(buffer);
+    }
+
+    Pointer allocate(SizeType n) {
+        if (n == 0) {
+            return nullptr;
+        } else if (!used && n <= N) {
+            used = true;
+            return reinterpret_cast<Pointer>(buffer);
+        } else {
+            return fallback.allocate(n);
+        }
+    }
+
+    void deallocate(Pointer ptr, SizeType n) {
+        if (owns(ptr)) {
+            used = false;
+        } else {
+            fallback.deallocate(ptr, n);
+        }
+    }
+
+    bool expand(Pointer ptr, SizeType n, SizeType new_n) {
+        if (owns(ptr)) {
+            return new_n <= N;
+        } else {
+            return AllocatorTraits<ValueType, Fallback>::expand(fallback, ptr, n, new_n);
+        }
+    }
+
+    Pointer reallocate(Pointer ptr, SizeType n, SizeType new_n) requires AllocatorTraits<ValueType, Fallback>::can_reallocate {
+        return owns(ptr) ? nullptr : fallback.reallocate(ptr, n, new_n);
     }
 
+private:
+    alignas(ValueType) unsigned char buffer[N*sizeof(ValueType)];
+    bool used;
+    Fallback fallback;
 };
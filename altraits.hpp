@@ -1,6 +1,10 @@
 #pragma once
 
 #include <concepts>
+#include <utility>
+#include <type_traits>
+#include <new>
+#include <cstring>
 
 template <typename T>
 concept TAllocator = requires (T alloc) {
@@ -8,6 +12,12 @@ concept TAllocator = requires (T alloc) {
     alloc.deallocate(std::declval<typename T::Pointer>(), std::declval<typename T::SizeType>());
 };
 
+// Types that can be moved to another address with memcpy, leaving nothing to destroy
+// behind. Trivially copyable types are such by default; other types (e.g. ones holding
+// only owning pointers) may opt in by specializing this variable.
+template <typename T>
+inline constexpr bool is_trivially_relocatable = std::is_trivially_copyable_v<T>;
+
 template <typename ValueType, TAllocator Alloc>
 class AllocatorTraits {
 public:
@@ -15,17 +25,81 @@ public:
     using Pointer       = typename Alloc::Pointer;
     using SizeType      = typename Alloc::SizeType;
 
+    // monotonic allocators release their memory all at once, so containers may skip
+    // per-element teardown when there are no destructors to run
+    static constexpr bool is_monotonic = requires { requires Alloc::is_monotonic; };
+    static constexpr bool skip_teardown = is_monotonic && std::is_trivially_destructible_v<ValueType>;
+
+    // optional allocator extensions: expand(ptr, n, new_n) grows a block in place and
+    // reports success, reallocate(ptr, n, new_n) may move it bitwise, as realloc does
+    static constexpr bool can_expand = requires (Alloc alloc, Pointer ptr, SizeType n) {
+        {alloc.expand(ptr, n, n)} -> std::same_as<bool>;
+    };
+    static constexpr bool can_reallocate = requires (Alloc alloc, Pointer ptr, SizeType n) {
+        {alloc.reallocate(ptr, n, n)} -> std::same_as<Pointer>;
+    };
+
+    // allocators keeping a buffer inside themselves (InlineAllocator) expose its size;
+    // memory from that buffer stays with the allocator object and can't be handed over
+    static constexpr bool has_inline_storage = requires { Alloc::inline_capacity; };
+
     template <typename... Args>
     static void construct(const Alloc& alloc, Pointer ptr, Args&&... args) {
-        *ptr = std::move(ValueType(std::forward<Args>(args)...));
+        ::new (static_cast<void*>(ptr)) ValueType(std::forward<Args>(args)...);
     }
     static void destroy(const Alloc& alloc, ValueType* ptr) {
         ptr->~ValueType();
     }
+
+    // moves n objects from src to dst and ends their lifetime at src;
+    // the ranges may overlap, as with memmove
+    static void relocate(const Alloc& alloc, Pointer dst, Pointer src, SizeType n) {
+        if (n == 0 || dst == src) {
+            return;
+        } else if constexpr (is_trivially_relocatable<ValueType>) {
+            std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), n*sizeof(ValueType));
+        } else if (dst < src) {
+            for (SizeType i = 0; i < n; ++i) {
+                construct(alloc, dst + i, std::move(*(src + i)));
+                destroy(alloc, src + i);
+            }
+        } else {
+            for (SizeType i = n; i > 0; --i) {
+                construct(alloc, dst + i - 1, std::move(*(src + i - 1)));
+                destroy(alloc, src + i - 1);
+            }
+        }
+    }
     static typename Alloc::Pointer allocate(Alloc& alloc, typename Alloc::SizeType n) {
         return alloc.allocate(n);
     }
     static void deallocate(Alloc& alloc, Pointer ptr, typename Alloc::SizeType n) {
         alloc.deallocate(ptr, n);
     }
+    static bool expand(Alloc& alloc, Pointer ptr, SizeType n, SizeType new_n) {
+        if constexpr (can_expand) {
+            return ptr && new_n >= n && alloc.expand(ptr, n, new_n);
+        } else {
+            return false;
+        }
+    }
+
+    // moves the first size objects of a block of n slots into a block of new_n slots,
+    // extending or reallocating the block in place when the allocator allows it
+    static Pointer reallocate(Alloc& alloc, Pointer ptr, SizeType n, SizeType new_n, SizeType size) {
+        if (expand(alloc, ptr, n, new_n)) return ptr;
+        if constexpr (can_reallocate && is_trivially_relocatable<ValueType>) {
+            if (ptr && new_n) {
+                Pointer newptr = alloc.reallocate(ptr, n, new_n);
+                if (newptr) return newptr;
+            }
+        }
+        // a null from alloc.reallocate means it left ptr as it was; a null from allocate is
+        // a failure, and ptr has to stay intact for the caller
+        Pointer newptr = allocate(alloc, new_n);
+        if (!newptr && new_n) throw std::bad_alloc();
+        relocate(alloc, newptr, ptr, size);
+        deallocate(alloc, ptr, n);
+        return newptr;
+    }
 };
@@ -4,6 +4,10 @@
 #include "altraits.hpp"
 #include "iterators.hpp"
 #include "exceptions.hpp"
+#include "simd.hpp"
+#include "radix.hpp"
+#include "snapshot.hpp"
+#include <functional>
 #include <initializer_list>
 
 template <typename Array, typename ValueType>
@@ -16,13 +20,71 @@ concept IsArrayLike = requires(Array v) {
     {v.size()} -> std::same_as<typename Array::SizeType>;
 };
 
+// Growth policies decide the capacity an Array moves to when it needs room
+// for required elements while holding cap slots; the result is never below required.
+template <typename T>
+concept GrowthPolicy = requires (size_t cap, size_t required) {
+    {T::next(cap, required)} -> std::same_as<size_t>;
+};
+
+struct DoubleGrowth {
+    static size_t next(size_t cap, size_t required) noexcept {
+        return (2*cap > required ? 2*cap : required);
+    }
+};
+
+struct HalfGrowth {
+    static size_t next(size_t cap, size_t required) noexcept {
+        return (cap + cap/2 > required ? cap + cap/2 : required);
+    }
+};
+
+template <size_t Step>
+struct StepGrowth {
+    static_assert(Step > 0, "Growth step must be positive");
+    static size_t next(size_t cap, size_t required) noexcept {
+        return (cap + Step > required ? cap + Step : (required + Step - 1) / Step * Step);
+    }
+};
+
 template <std::default_initializable ValueType,
-            TAllocator AllocatorType>
+            TAllocator AllocatorType,
+            GrowthPolicy GrType>
 class Array;
 
 template <std::default_initializable VType>
 class Slice;
 
+template <std::default_initializable VType> requires std::is_trivially_copyable_v<VType>
+class MappedArray;
+
+template <TAllocator AlType, GrowthPolicy GrType, std::default_initializable... Fields> requires (sizeof...(Fields) > 0)
+class BasicSoAArray;
+
+template <std::default_initializable VType, TAllocator AlType>
+class RingBuffer;
+
+template <std::default_initializable VType>
+class StridedSlice;
+
+template <std::default_initializable VType, size_t Dims> requires (Dims >= 2)
+class NDSlice;
+
+
+// strides of a dense row-major layout of the given shape, which must fit into size elements
+template <size_t Dims>
+struct RowMajor {
+    size_t stride[Dims];
+
+    RowMajor(size_t size, const size_t (&shape)[Dims]) {
+        size_t total = 1;
+        for (size_t d = Dims; d > 0; --d) {
+            stride[d - 1] = total;
+            total *= shape[d - 1];
+        }
+        if (total > size) throw InvalidView();
+    }
+};
 
 template <typename ValueType>
 class arrayIterator : public RandomAccessIterator<ValueType> {
@@ -35,158 +97,144 @@ public:
     using ItDiff            = typename Base::ItDiff;
     using SizeType          = typename Base::SizeType;
 
-    template <std::default_initializable VT, TAllocator AllocatorType>
+    static constexpr bool is_contiguous = true;
+
+    template <std::default_initializable VT, TAllocator AllocatorType, GrowthPolicy GrType>
     friend class Array;
 
     template <std::default_initializable VT>
     friend class Slice;
 
+    template <std::default_initializable VT> requires std::is_trivially_copyable_v<VT>
+    friend class MappedArray;
+
+    template <TAllocator AllocatorType, GrowthPolicy GrType, std::default_initializable... Fields> requires (sizeof...(Fields) > 0)
+    friend class BasicSoAArray;
+
 private:
     arrayIterator(const Pointer& begin, const SizeType& size, SizeType pos) : begin(begin), size(size), pos(pos) {}
 
 public:
 
-    arrayIterator(const Base& it) : arrayIterator(static_cast<const arrayIterator&>(it)) {}
-    arrayIterator(const BidirectionalIterator<ValueType>& it) : arrayIterator(static_cast<const arrayIterator&>(it)) {}
-    arrayIterator(const ForwardIterator<ValueType>& it) : arrayIterator(static_cast<const arrayIterator&>(it)) {}
-
-    bool operator==(const ForwardIterator<ValueType>& it) const noexcept override {
-        arrayIterator _it = static_cast<const arrayIterator<ValueType>&>(it);
-        return begin == _it.begin && size == _it.size && pos == _it.pos;
+    bool operator==(const arrayIterator& it) const noexcept {
+        if constexpr (checked_access) {
+            return begin == it.begin && size == it.size && pos == it.pos;
+        } else {
+            return pos == it.pos;
+        }
     }
 
-    bool operator!=(const ForwardIterator<ValueType>& it) const noexcept override {
-        arrayIterator _it = static_cast<const arrayIterator<ValueType>&>(it);
-        return begin != _it.begin || size != _it.size || pos != _it.pos;
+    bool operator!=(const arrayIterator& it) const noexcept {
+        return !(*this == it);
     }
 
-    bool operator>(const Base& it) const override {
-        arrayIterator _it = static_cast<const arrayIterator<ValueType>&>(it);
-        if (begin != _it.begin || size != _it.size) {
-                throw NotComparableIterators();
-        } else {
-            return pos > _it.pos;
+    bool operator>(const arrayIterator& it) const {
+        if constexpr (checked_access) {
+            if (begin != it.begin || size != it.size) throw NotComparableIterators();
         }
+        return pos > it.pos;
     }
 
-    bool operator<(const Base& it) const override {
-        arrayIterator _it = static_cast<const arrayIterator<ValueType>&>(it);
-        if (begin != _it.begin || size != _it.size) {
-                throw NotComparableIterators();
-        } else {
-            return pos < _it.pos;
+    bool operator<(const arrayIterator& it) const {
+        if constexpr (checked_access) {
+            if (begin != it.begin || size != it.size) throw NotComparableIterators();
         }
+        return pos < it.pos;
     }
 
-    bool operator>=(const Base& it) const override {
-        arrayIterator _it = static_cast<const arrayIterator<ValueType>&>(it);
-        if (begin != _it.begin || size != _it.size) {
-                throw NotComparableIterators();
-        } else {
-            return pos >= _it.pos;
+    bool operator>=(const arrayIterator& it) const {
+        if constexpr (checked_access) {
+            if (begin != it.begin || size != it.size) throw NotComparableIterators();
         }
+        return pos >= it.pos;
     }
 
-    bool operator<=(const Base& it) const override {
-        arrayIterator _it = static_cast<const arrayIterator<ValueType>&>(it);
-        if (begin != _it.begin || size != _it.size) {
-                throw NotComparableIterators();
-        } else {
-            return pos <= _it.pos;
+    bool operator<=(const arrayIterator& it) const {
+        if constexpr (checked_access) {
+            if (begin != it.begin || size != it.size) throw NotComparableIterators();
         }
+        return pos <= it.pos;
     }
 
-    Reference operator*() const override {
-        if (pos >= size) {
-            throw UndereferencableIterator();
-        } else {
-            return *(begin + pos);
+    Reference operator*() const {
+        if constexpr (checked_access) {
+            if (pos >= size) throw UndereferencableIterator();
         }
+        return *(begin + pos);
     }
 
-    Pointer operator->() const override {
-        if (pos >= size) {
-            throw UndereferencableIterator();
-        } else {
-            return begin + pos;
+    Pointer operator->() const {
+        if constexpr (checked_access) {
+            if (pos >= size) throw UndereferencableIterator();
         }
+        return begin + pos;
     }
 
-    ForwardIterator<ValueType>& operator++() override {
-        if (pos >= size) {
-            throw IteratorOutOfBounds();
-        } else {
-            ++pos;
-            return static_cast<ForwardIterator<ValueType>&>(*this);
+    arrayIterator& operator++() {
+        if constexpr (checked_access) {
+            if (pos >= size) throw IteratorOutOfBounds();
         }
+        ++pos;
+        return *this;
     }
 
     arrayIterator operator++(int) {
-        if (pos >= size) {
-            throw IteratorOutOfBounds();
-        } else {
-            return arrayIterator(begin, size, pos++);
+        if constexpr (checked_access) {
+            if (pos >= size) throw IteratorOutOfBounds();
         }
+        return arrayIterator(begin, size, pos++);
     }
 
-    BidirectionalIterator<ValueType>& operator--() override {
-        if (pos == 0) {
-            throw IteratorOutOfBounds();
-        } else {
-            --pos;
-            return static_cast<BidirectionalIterator<ValueType>&>(*this);
+    arrayIterator& operator--() {
+        if constexpr (checked_access) {
+            if (pos == 0) throw IteratorOutOfBounds();
         }
+        --pos;
+        return *this;
     }
 
     arrayIterator operator--(int) {
-        if (pos == 0) {
-            throw IteratorOutOfBounds();
-        } else {
-            return arrayIterator(begin, size, pos--);
+        if constexpr (checked_access) {
+            if (pos == 0) throw IteratorOutOfBounds();
         }
+        return arrayIterator(begin, size, pos--);
     }
 
-    Base& operator+=(ItDiff offset) override {
-        if (pos + offset >= 0 && pos + offset <= size) {
-            pos += offset;
-            return static_cast<Base&>(*this);
-        } else {
-            throw IteratorOutOfBounds();
+    arrayIterator& operator+=(ItDiff offset) {
+        if constexpr (checked_access) {
+            if (pos + offset > size) throw IteratorOutOfBounds();
         }
+        pos += offset;
+        return *this;
     }
 
-    Base& operator-=(ItDiff offset) override {
-        if (pos - offset >= 0 && pos - offset <= size) {
-            pos -= offset;
-            return static_cast<Base&>(*this);
-        } else {
-            throw IteratorOutOfBounds();
+    arrayIterator& operator-=(ItDiff offset) {
+        if constexpr (checked_access) {
+            if (pos - offset > size) throw IteratorOutOfBounds();
         }
+        pos -= offset;
+        return *this;
     }
 
     arrayIterator operator+ (ItDiff offset) const {
-        if (pos + offset >= 0 && pos + offset <= size) {
-            return arrayIterator(begin, size, pos + offset);
-        } else {
-            throw IteratorOutOfBounds();
+        if constexpr (checked_access) {
+            if (pos + offset > size) throw IteratorOutOfBounds();
         }
+        return arrayIterator(begin, size, pos + offset);
     }
 
     arrayIterator operator- (ItDiff offset) const {
-        if (pos - offset >= 0 && pos - offset <= size) {
-            return arrayIterator(begin, size, pos - offset);
-        } else {
-            throw IteratorOutOfBounds();
+        if constexpr (checked_access) {
+            if (pos - offset > size) throw IteratorOutOfBounds();
         }
+        return arrayIterator(begin, size, pos - offset);
     }
 
-    ItDiff operator- (const Base& it) const override {
-        arrayIterator _it = static_cast<const arrayIterator&>(it);
-        if (_it.begin == begin && _it.size == size) {
-            return ItDiff(pos) - _it.pos;
-        } else {
-            throw NotComparableIterators();
+    ItDiff operator- (const arrayIterator& it) const {
+        if constexpr (checked_access) {
+            if (it.begin != begin || it.size != size) throw NotComparableIterators();
         }
+        return ItDiff(pos) - it.pos;
     }
 
 private:
@@ -206,154 +254,144 @@ public:
     using ItDiff            = typename Base::ItDiff;
     using SizeType          = typename Base::SizeType;
 
-    template <std::default_initializable VT, TAllocator AllocatorType>
+    static constexpr bool is_contiguous = true;
+
+    template <std::default_initializable VT, TAllocator AllocatorType, GrowthPolicy GrType>
     friend class Array;
 
     template <std::default_initializable VT>
     friend class Slice;
 
+    template <std::default_initializable VT> requires std::is_trivially_copyable_v<VT>
+    friend class MappedArray;
+
+    template <TAllocator AllocatorType, GrowthPolicy GrType, std::default_initializable... Fields> requires (sizeof...(Fields) > 0)
+    friend class BasicSoAArray;
+
 private:
     constArrayIterator(const Pointer& begin, const SizeType& size, SizeType pos) : begin(begin), size(size), pos(pos) {}
 
 public:
 
-    bool operator==(const ConstForwardIterator<ValueType>& it) const noexcept override {
-        constArrayIterator _it = static_cast<const constArrayIterator<ValueType>&>(it);
-        return begin == _it.begin && size == _it.size && pos == _it.pos;
+    bool operator==(const constArrayIterator& it) const noexcept {
+        if constexpr (checked_access) {
+            return begin == it.begin && size == it.size && pos == it.pos;
+        } else {
+            return pos == it.pos;
+        }
     }
 
-    bool operator!=(const ConstForwardIterator<ValueType>& it) const noexcept override {
-        constArrayIterator _it = static_cast<const constArrayIterator<ValueType>&>(it);
-        return begin != _it.begin || size != _it.size || pos != _it.pos;
+    bool operator!=(const constArrayIterator& it) const noexcept {
+        return !(*this == it);
     }
 
-    bool operator>(const Base& it) const override {
-        constArrayIterator _it = static_cast<const constArrayIterator<ValueType>&>(it);
-        if (begin != _it.begin || size != _it.size) {
-                throw NotComparableIterators();
-        } else {
-            return pos > _it.pos;
+    bool operator>(const constArrayIterator& it) const {
+        if constexpr (checked_access) {
+            if (begin != it.begin || size != it.size) throw NotComparableIterators();
         }
+        return pos > it.pos;
     }
 
-    bool operator<(const Base& it) const override {
-        constArrayIterator _it = static_cast<const constArrayIterator<ValueType>&>(it);
-        if (begin != _it.begin || size != _it.size) {
-                throw NotComparableIterators();
-        } else {
-            return pos < _it.pos;
+    bool operator<(const constArrayIterator& it) const {
+        if constexpr (checked_access) {
+            if (begin != it.begin || size != it.size) throw NotComparableIterators();
         }
+        return pos < it.pos;
     }
 
-    bool operator>=(const Base& it) const override {
-        constArrayIterator _it = static_cast<const constArrayIterator<ValueType>&>(it);
-        if (begin != _it.begin || size != _it.size) {
-                throw NotComparableIterators();
-        } else {
-            return pos >= _it.pos;
+    bool operator>=(const constArrayIterator& it) const {
+        if constexpr (checked_access) {
+            if (begin != it.begin || size != it.size) throw NotComparableIterators();
         }
+        return pos >= it.pos;
     }
 
-    bool operator<=(const Base& it) const override {
-        constArrayIterator _it = static_cast<const constArrayIterator<ValueType>&>(it);
-        if (begin != _it.begin || size != _it.size) {
-                throw NotComparableIterators();
-        } else {
-            return pos <= _it.pos;
+    bool operator<=(const constArrayIterator& it) const {
+        if constexpr (checked_access) {
+            if (begin != it.begin || size != it.size) throw NotComparableIterators();
         }
+        return pos <= it.pos;
     }
 
-    ConstReference operator*() const override {
-        if (pos >= size) {
-            throw UndereferencableIterator();
-        } else {
-            return *(begin + pos);
+    ConstReference operator*() const {
+        if constexpr (checked_access) {
+            if (pos >= size) throw UndereferencableIterator();
         }
+        return *(begin + pos);
     }
 
-    ConstPointer operator->() const override {
-        if (pos >= size) {
-            throw UndereferencableIterator();
-        } else {
-            return begin + pos;
+    ConstPointer operator->() const {
+        if constexpr (checked_access) {
+            if (pos >= size) throw UndereferencableIterator();
         }
+        return begin + pos;
     }
 
-    ConstForwardIterator<ValueType>& operator++() override {
-        if (pos >= size) {
-            throw IteratorOutOfBounds();
-        } else {
-            ++pos;
-            return static_cast<ConstForwardIterator<ValueType>&>(*this);
+    constArrayIterator& operator++() {
+        if constexpr (checked_access) {
+            if (pos >= size) throw IteratorOutOfBounds();
         }
+        ++pos;
+        return *this;
     }
 
     constArrayIterator operator++(int) {
-        if (pos >= size) {
-            throw IteratorOutOfBounds();
-        } else {
-            return constArrayIterator(begin, size, pos++);
+        if constexpr (checked_access) {
+            if (pos >= size) throw IteratorOutOfBounds();
         }
+        return constArrayIterator(begin, size, pos++);
     }
 
-    ConstBidirectionalIterator<ValueType>& operator--() override {
-        if (pos == 0) {
-            throw IteratorOutOfBounds();
-        } else {
-            --pos;
-            return static_cast<ConstBidirectionalIterator<ValueType>&>(*this);
+    constArrayIterator& operator--() {
+        if constexpr (checked_access) {
+            if (pos == 0) throw IteratorOutOfBounds();
         }
+        --pos;
+        return *this;
     }
 
     constArrayIterator operator--(int) {
-        if (pos == 0) {
-            throw IteratorOutOfBounds();
-        } else {
-            return constArrayIterator(begin, size, pos--);
+        if constexpr (checked_access) {
+            if (pos == 0) throw IteratorOutOfBounds();
         }
+        return constArrayIterator(begin, size, pos--);
     }
 
-    Base& operator+=(ItDiff offset) override {
-        if (pos + offset >= 0 && pos + offset <= size) {
-            pos += offset;
-            return static_cast<Base&>(*this);
-        } else {
-            throw IteratorOutOfBounds();
+    constArrayIterator& operator+=(ItDiff offset) {
+        if constexpr (checked_access) {
+            if (pos + offset > size) throw IteratorOutOfBounds();
         }
+        pos += offset;
+        return *this;
     }
 
-    Base& operator-=(ItDiff offset) override {
-        if (pos - offset >= 0 && pos - offset <= size) {
-            pos -= offset;
-            return static_cast<Base&>(*this);
-        } else {
-            throw IteratorOutOfBounds();
+    constArrayIterator& operator-=(ItDiff offset) {
+        if constexpr (checked_access) {
+            if (pos - offset > size) throw IteratorOutOfBounds();
         }
+        pos -= offset;
+        return *this;
     }
 
     constArrayIterator operator+ (ItDiff offset) const {
-        if (pos + offset >= 0 && pos + offset <= size) {
-            return constArrayIterator(begin, size, pos + offset);
-        } else {
-            throw IteratorOutOfBounds();
+        if constexpr (checked_access) {
+            if (pos + offset > size) throw IteratorOutOfBounds();
         }
+        return constArrayIterator(begin, size, pos + offset);
     }
 
     constArrayIterator operator- (ItDiff offset) const {
-        if (pos - offset >= 0 && pos - offset <= size) {
-            return constArrayIterator(begin, size, pos - offset);
-        } else {
-            throw IteratorOutOfBounds();
+        if constexpr (checked_access) {
+            if (pos - offset > size) throw IteratorOutOfBounds();
         }
+        return constArrayIterator(begin, size, pos - offset);
     }
 
-    ItDiff operator- (const Base& it) const override {
-        constArrayIterator _it = static_cast<const constArrayIterator&>(it);
-        if (_it.begin == begin && _it.size == size) {
-            return ItDiff(pos) - _it.pos;
-        } else {
-            throw NotComparableIterators();
+    ItDiff operator- (const constArrayIterator& it) const {
+        if constexpr (checked_access) {
+            if (it.begin != begin || it.size != size) throw NotComparableIterators();
         }
+        return ItDiff(pos) - it.pos;
     }
 
 private:
@@ -376,9 +414,18 @@ public:
     using SizeType              = typename Iterator::SizeType;
     using ItDiff                = typename Iterator::ItDiff;
 
-    template<std::default_initializable ValueType, TAllocator AlType>
+    template<std::default_initializable ValueType, TAllocator AlType, GrowthPolicy GrType>
     friend class Array;
 
+    template <std::default_initializable VT> requires std::is_trivially_copyable_v<VT>
+    friend class MappedArray;
+
+    template <TAllocator AllocatorType, GrowthPolicy GrType, std::default_initializable... Fields> requires (sizeof...(Fields) > 0)
+    friend class BasicSoAArray;
+
+    template <std::default_initializable VT, TAllocator AllocatorType>
+    friend class RingBuffer;
+
     Iterator begin() noexcept {
         return Iterator(arr, _size, 0);
     }
@@ -399,11 +446,67 @@ public:
         return _size;
     }
 
-    ValueType& operator[](ItDiff ind) noexcept {
+    Iterator find(const ValueType& val) noexcept requires std::equality_comparable<ValueType> {
+        return Iterator(arr, _size, SimdKernels<ValueType>::find(arr, _size, val));
+    }
+
+    ConstIterator find(const ValueType& val) const noexcept requires std::equality_comparable<ValueType> {
+        return ConstIterator(arr, _size, SimdKernels<ValueType>::find(arr, _size, val));
+    }
+
+    SizeType count(const ValueType& val) const noexcept requires std::equality_comparable<ValueType> {
+        return SimdKernels<ValueType>::count(arr, _size, val);
+    }
+
+    bool contains(const ValueType& val) const noexcept requires std::equality_comparable<ValueType> {
+        return SimdKernels<ValueType>::find(arr, _size, val) != _size;
+    }
+
+    void fill(const ValueType& val) {
+        SimdKernels<ValueType>::fill(arr, _size, val);
+    }
+
+    ValueType min() const requires std::totally_ordered<ValueType> {
+        if (_size == 0) throw EmptyCollection();
+        return SimdKernels<ValueType>::min(arr, _size);
+    }
+
+    ValueType max() const requires std::totally_ordered<ValueType> {
+        if (_size == 0) throw EmptyCollection();
+        return SimdKernels<ValueType>::max(arr, _size);
+    }
+
+    ValueType sum() const noexcept requires requires (ValueType a) { a += a; } {
+        return SimdKernels<ValueType>::sum(arr, _size);
+    }
+
+    // as in Array; a slice doesn't know its array's allocator, so the scratch buffer
+    // comes from alloc (pass the array's one to keep it in the same memory)
+    template <RadixKeyExtractor<ValueType> KeyFn = RadixIdentity, TAllocator AlType = Allocator<ValueType>>
+    void radix_sort(const KeyFn& key = KeyFn(), AlType alloc = AlType()) {
+        RadixKernels<ValueType, KeyFn>::lsd(arr, _size, key, alloc);
+    }
+
+    template <RadixKeyExtractor<ValueType> KeyFn = RadixIdentity>
+    void radix_sort_in_place(const KeyFn& key = KeyFn()) {
+        RadixKernels<ValueType, KeyFn>::msd(arr, _size, key);
+    }
+
+    // index taken modulo size, negative indices count from the end
+    ValueType& at(ItDiff ind) noexcept {
         if (ind >= 0) {
             return *(arr + (ind % _size));
         } else {
-            return *(arr + (_size + ind % _size) % _size);
+            return *(arr + (_size + ind % ItDiff(_size)) % _size);
+        }
+    }
+
+    // wraps like at() in checked mode, plain offset in unchecked mode
+    ValueType& operator[](ItDiff ind) noexcept {
+        if constexpr (checked_access) {
+            return at(ind);
+        } else {
+            return *(arr + ind);
         }
     }
 
@@ -414,13 +517,25 @@ public:
             *(arr + i) = *it;
         }
     }
-    template <TAllocator AlType>
-    void operator=(const Array<ValueType, AlType>& array) {
+    template <TAllocator AlType, GrowthPolicy GrType>
+    void operator=(const Array<ValueType, AlType, GrType>& array) {
         SizeType minsz = (array.size() < _size ? array.size() : _size);
-        for (SizeType i = 0; i < minsz; ++i) {
-            *(arr + i) = array[i];
+        auto it = array.cbegin();
+        for (SizeType i = 0; i < minsz; ++i, ++it) {
+            *(arr + i) = *it;
         }
     }
+
+    // every step-th element of [from, to)
+    StridedSlice<ValueType> slice(SizeType from, SizeType to, SizeType step = 1) {
+        return StridedSlice<ValueType>(arr, _size, 1).slice(from, to, step);
+    }
+
+    // the first elements seen as a row-major array of the given shape
+    template <size_t Dims> requires (Dims >= 2)
+    NDSlice<ValueType, Dims> view(const SizeType (&shape)[Dims]) {
+        return NDSlice<ValueType, Dims>(arr, shape, RowMajor(_size, shape).stride);
+    }
 private:
     Pointer arr;
     SizeType _size;
@@ -428,8 +543,591 @@ private:
     Slice(Pointer begin, SizeType size) : arr(begin), _size(size) {}
 };
 
+template <typename ValueType>
+class stridedIterator : public RandomAccessIterator<ValueType> {
+public:
+    using Base              = RandomAccessIterator<ValueType>;
+    using Pointer           = typename Base::Pointer;
+    using ConstPointer      = typename Base::ConstPointer;
+    using Reference         = typename Base::Reference;
+    using ConstReference    = typename Base::ConstReference;
+    using ItDiff            = typename Base::ItDiff;
+    using SizeType          = typename Base::SizeType;
+
+    template <std::default_initializable VT>
+    friend class StridedSlice;
+
+private:
+    stridedIterator(Pointer begin, SizeType size, SizeType step, SizeType pos) : begin(begin), size(size), step(step), pos(pos) {}
+
+public:
+
+    bool operator==(const stridedIterator& it) const noexcept {
+        if constexpr (checked_access) {
+            return begin == it.begin && size == it.size && step == it.step && pos == it.pos;
+        } else {
+            return pos == it.pos;
+        }
+    }
+
+    bool operator!=(const stridedIterator& it) const noexcept {
+        return !(*this == it);
+    }
+
+    bool operator>(const stridedIterator& it) const {
+        Check(it);
+        return pos > it.pos;
+    }
+
+    bool operator<(const stridedIterator& it) const {
+        Check(it);
+        return pos < it.pos;
+    }
+
+    bool operator>=(const stridedIterator& it) const {
+        Check(it);
+        return pos >= it.pos;
+    }
+
+    bool operator<=(const stridedIterator& it) const {
+        Check(it);
+        return pos <= it.pos;
+    }
+
+    Reference operator*() const {
+        if constexpr (checked_access) {
+            if (pos >= size) throw UndereferencableIterator();
+        }
+        return *(begin + pos*step);
+    }
+
+    Pointer operator->() const {
+        if constexpr (checked_access) {
+            if (pos >= size) throw UndereferencableIterator();
+        }
+        return begin + pos*step;
+    }
+
+    stridedIterator& operator++() {
+        if constexpr (checked_access) {
+            if (pos >= size) throw IteratorOutOfBounds();
+        }
+        ++pos;
+        return *this;
+    }
+
+    stridedIterator operator++(int) {
+        stridedIterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    stridedIterator& operator--() {
+        if constexpr (checked_access) {
+            if (pos == 0) throw IteratorOutOfBounds();
+        }
+        --pos;
+        return *this;
+    }
+
+    stridedIterator operator--(int) {
+        stridedIterator it = *this;
+        --*this;
+        return it;
+    }
+
+    stridedIterator& operator+=(ItDiff offset) {
+        if constexpr (checked_access) {
+            if (pos + offset > size) throw IteratorOutOfBounds();
+        }
+        pos += offset;
+        return *this;
+    }
+
+    stridedIterator& operator-=(ItDiff offset) {
+        return *this += -offset;
+    }
+
+    stridedIterator operator+ (ItDiff offset) const {
+        stridedIterator it = *this;
+        return it += offset;
+    }
+
+    stridedIterator operator- (ItDiff offset) const {
+        stridedIterator it = *this;
+        return it += -offset;
+    }
+
+    ItDiff operator- (const stridedIterator& it) const {
+        Check(it);
+        return ItDiff(pos) - it.pos;
+    }
+
+private:
+    void Check(const stridedIterator& it) const {
+        if constexpr (checked_access) {
+            if (begin != it.begin || size != it.size || step != it.step) throw NotComparableIterators();
+        }
+    }
+
+    // held by value: a strided view never changes, unlike an array that can reallocate
+    Pointer begin;
+    SizeType size, step, pos;
+};
+
+template <typename ValueType>
+class constStridedIterator : public ConstRandomAccessIterator<ValueType> {
+public:
+    using Base              = ConstRandomAccessIterator<ValueType>;
+    using Pointer           = typename Base::Pointer;
+    using ConstPointer      = typename Base::ConstPointer;
+    using Reference         = typename Base::Reference;
+    using ConstReference    = typename Base::ConstReference;
+    using ItDiff            = typename Base::ItDiff;
+    using SizeType          = typename Base::SizeType;
+
+    template <std::default_initializable VT>
+    friend class StridedSlice;
+
+private:
+    constStridedIterator(ConstPointer begin, SizeType size, SizeType step, SizeType pos) : begin(begin), size(size), step(step), pos(pos) {}
+
+public:
+
+    bool operator==(const constStridedIterator& it) const noexcept {
+        if constexpr (checked_access) {
+            return begin == it.begin && size == it.size && step == it.step && pos == it.pos;
+        } else {
+            return pos == it.pos;
+        }
+    }
+
+    bool operator!=(const constStridedIterator& it) const noexcept {
+        return !(*this == it);
+    }
+
+    bool operator>(const constStridedIterator& it) const {
+        Check(it);
+        return pos > it.pos;
+    }
+
+    bool operator<(const constStridedIterator& it) const {
+        Check(it);
+        return pos < it.pos;
+    }
+
+    bool operator>=(const constStridedIterator& it) const {
+        Check(it);
+        return pos >= it.pos;
+    }
+
+    bool operator<=(const constStridedIterator& it) const {
+        Check(it);
+        return pos <= it.pos;
+    }
+
+    ConstReference operator*() const {
+        if constexpr (checked_access) {
+            if (pos >= size) throw UndereferencableIterator();
+        }
+        return *(begin + pos*step);
+    }
+
+    ConstPointer operator->() const {
+        if constexpr (checked_access) {
+            if (pos >= size) throw UndereferencableIterator();
+        }
+        return begin + pos*step;
+    }
+
+    constStridedIterator& operator++() {
+        if constexpr (checked_access) {
+            if (pos >= size) throw IteratorOutOfBounds();
+        }
+        ++pos;
+        return *this;
+    }
+
+    constStridedIterator operator++(int) {
+        constStridedIterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    constStridedIterator& operator--() {
+        if constexpr (checked_access) {
+            if (pos == 0) throw IteratorOutOfBounds();
+        }
+        --pos;
+        return *this;
+    }
+
+    constStridedIterator operator--(int) {
+        constStridedIterator it = *this;
+        --*this;
+        return it;
+    }
+
+    constStridedIterator& operator+=(ItDiff offset) {
+        if constexpr (checked_access) {
+            if (pos + offset > size) throw IteratorOutOfBounds();
+        }
+        pos += offset;
+        return *this;
+    }
+
+    constStridedIterator& operator-=(ItDiff offset) {
+        return *this += -offset;
+    }
+
+    constStridedIterator operator+ (ItDiff offset) const {
+        constStridedIterator it = *this;
+        return it += offset;
+    }
+
+    constStridedIterator operator- (ItDiff offset) const {
+        constStridedIterator it = *this;
+        return it += -offset;
+    }
+
+    ItDiff operator- (const constStridedIterator& it) const {
+        Check(it);
+        return ItDiff(pos) - it.pos;
+    }
+
+private:
+    void Check(const constStridedIterator& it) const {
+        if constexpr (checked_access) {
+            if (begin != it.begin || size != it.size || step != it.step) throw NotComparableIterators();
+        }
+    }
+
+    ConstPointer begin;
+    SizeType size, step, pos;
+};
+
+// Every step-th element of an array: matrix columns, interleaved channels and the like.
+// With step 1 the search, fill and reductions go through SimdKernels as for Slice.
+template <std::default_initializable VType>
+class StridedSlice {
+
+public:
+    using ValueType             = VType;
+    using Pointer               = ValueType*;
+    using Reference             = ValueType&;
+    using ConstPointer          = const ValueType*;
+    using ConstReference        = const ValueType&;
+    using Iterator              = stridedIterator<ValueType>;
+    using ConstIterator         = constStridedIterator<ValueType>;
+    using SizeType              = typename Iterator::SizeType;
+    using ItDiff                = typename Iterator::ItDiff;
+
+    template <std::default_initializable VT, TAllocator AllocatorType, GrowthPolicy GrType>
+    friend class Array;
+
+    template <std::default_initializable VT>
+    friend class Slice;
+
+    template <std::default_initializable VT, size_t Dims> requires (Dims >= 2)
+    friend class NDSlice;
+
+    Iterator begin() noexcept {
+        return Iterator(arr, _size, _step, 0);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return ConstIterator(arr, _size, _step, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(arr, _size, _step, _size);
+    }
+
+    ConstIterator cend() const noexcept {
+        return ConstIterator(arr, _size, _step, _size);
+    }
+
+    SizeType size() const noexcept {
+        return _size;
+    }
+
+    SizeType step() const noexcept {
+        return _step;
+    }
+
+    Iterator find(const ValueType& val) noexcept requires std::equality_comparable<ValueType> {
+        return Iterator(arr, _size, _step, Find(val));
+    }
+
+    ConstIterator find(const ValueType& val) const noexcept requires std::equality_comparable<ValueType> {
+        return ConstIterator(arr, _size, _step, Find(val));
+    }
+
+    SizeType count(const ValueType& val) const noexcept requires std::equality_comparable<ValueType> {
+        if (_step == 1) return SimdKernels<ValueType>::count(arr, _size, val);
+        SizeType cnt = 0;
+        for (SizeType i = 0; i < _size; ++i) {
+            if (arr[i*_step] == val) ++cnt;
+        }
+        return cnt;
+    }
+
+    bool contains(const ValueType& val) const noexcept requires std::equality_comparable<ValueType> {
+        return Find(val) != _size;
+    }
+
+    void fill(const ValueType& val) {
+        if (_step == 1) {
+            SimdKernels<ValueType>::fill(arr, _size, val);
+        } else {
+            for (SizeType i = 0; i < _size; ++i) arr[i*_step] = val;
+        }
+    }
+
+    ValueType min() const requires std::totally_ordered<ValueType> {
+        if (_size == 0) throw EmptyCollection();
+        if (_step == 1) return SimdKernels<ValueType>::min(arr, _size);
+        ValueType res = arr[0];
+        for (SizeType i = 1; i < _size; ++i) {
+            if (arr[i*_step] < res) res = arr[i*_step];
+        }
+        return res;
+    }
+
+    ValueType max() const requires std::totally_ordered<ValueType> {
+        if (_size == 0) throw EmptyCollection();
+        if (_step == 1) return SimdKernels<ValueType>::max(arr, _size);
+        ValueType res = arr[0];
+        for (SizeType i = 1; i < _size; ++i) {
+            if (res < arr[i*_step]) res = arr[i*_step];
+        }
+        return res;
+    }
+
+    ValueType sum() const noexcept requires requires (ValueType a) { a += a; } {
+        if (_step == 1) return SimdKernels<ValueType>::sum(arr, _size);
+        ValueType res = ValueType();
+        for (SizeType i = 0; i < _size; ++i) res += arr[i*_step];
+        return res;
+    }
+
+    // index taken modulo size, negative indices count from the end
+    ValueType& at(ItDiff ind) noexcept {
+        if (ind >= 0) {
+            return arr[(ind % _size)*_step];
+        } else {
+            return arr[((_size + ind % ItDiff(_size)) % _size)*_step];
+        }
+    }
+
+    // wraps like at() in checked mode, plain offset in unchecked mode
+    ValueType& operator[](ItDiff ind) noexcept {
+        if constexpr (checked_access) {
+            return at(ind);
+        } else {
+            return arr[ind*ItDiff(_step)];
+        }
+    }
+
+    // every step-th element of [from, to) of this view, to clamped to its size
+    StridedSlice slice(SizeType from, SizeType to, SizeType step = 1) {
+        if (step == 0) throw InvalidView();
+        if (to > _size) to = _size;
+        if (from >= to) return StridedSlice(arr, 0, _step);
+        return StridedSlice(arr + from*_step, (to - from + step - 1) / step, _step*step);
+    }
+
+    void operator=(const std::initializer_list<ValueType>& list) {
+        SizeType minsz = (list.size() < _size ? list.size() : _size);
+        auto it = list.begin();
+        for (SizeType i = 0; i < minsz; ++i, ++it) {
+            arr[i*_step] = *it;
+        }
+    }
+
+    template <TAllocator AlType, GrowthPolicy GrType>
+    void operator=(const Array<ValueType, AlType, GrType>& array) {
+        SizeType minsz = (array.size() < _size ? array.size() : _size);
+        auto it = array.cbegin();
+        for (SizeType i = 0; i < minsz; ++i, ++it) {
+            arr[i*_step] = *it;
+        }
+    }
+
+private:
+    Pointer arr;
+    SizeType _size, _step;
+
+    StridedSlice(Pointer begin, SizeType size, SizeType step) : arr(begin), _size(size), _step(step) {}
+
+    SizeType Find(const ValueType& val) const noexcept {
+        if (_step == 1) return SimdKernels<ValueType>::find(arr, _size, val);
+        for (SizeType i = 0; i < _size; ++i) {
+            if (arr[i*_step] == val) return i;
+        }
+        return _size;
+    }
+};
+
+template <typename VType, size_t Dims>
+struct NDSubSlice {
+    using Type = NDSlice<VType, Dims - 1>;
+};
+
+template <typename VType>
+struct NDSubSlice<VType, 2> {
+    using Type = StridedSlice<VType>;
+};
+
+// Dims-dimensional view with a shape and a stride (in elements) per axis, e.g. a
+// row-major matrix over an array. Indexing the first axis gives a view with one axis
+// less, down to a StridedSlice; transpose() swaps axes, so columns are rows of the
+// transposed view. Bulk operations run over the innermost lines, through SimdKernels
+// when those are contiguous.
+template <std::default_initializable VType, size_t Dims> requires (Dims >= 2)
+class NDSlice {
+
+public:
+    using ValueType             = VType;
+    using Pointer               = ValueType*;
+    using Reference             = ValueType&;
+    using ConstPointer          = const ValueType*;
+    using ConstReference        = const ValueType&;
+    using SizeType              = size_t;
+    using SubSlice              = typename NDSubSlice<ValueType, Dims>::Type;
+
+    template <std::default_initializable VT, TAllocator AllocatorType, GrowthPolicy GrType>
+    friend class Array;
+
+    template <std::default_initializable VT>
+    friend class Slice;
+
+    template <std::default_initializable VT, size_t D> requires (D >= 2)
+    friend class NDSlice;
+
+    SizeType shape(size_t axis) const noexcept {
+        return _shape[axis];
+    }
+
+    SizeType stride(size_t axis) const noexcept {
+        return _stride[axis];
+    }
+
+    SizeType size() const noexcept {
+        SizeType res = 1;
+        for (size_t d = 0; d < Dims; ++d) res *= _shape[d];
+        return res;
+    }
+
+    template <std::convertible_to<SizeType>... Idx> requires (sizeof...(Idx) == Dims)
+    Reference operator()(Idx... idx) {
+        SizeType ind[Dims] = {static_cast<SizeType>(idx)...};
+        SizeType offset = 0;
+        for (size_t d = 0; d < Dims; ++d) {
+            if constexpr (checked_access) {
+                if (ind[d] >= _shape[d]) throw IteratorOutOfBounds();
+            }
+            offset += ind[d]*_stride[d];
+        }
+        return arr[offset];
+    }
+
+    // the view with the first axis fixed at ind
+    SubSlice operator[](SizeType ind) {
+        if constexpr (checked_access) {
+            if (ind >= _shape[0]) throw IteratorOutOfBounds();
+        }
+        if constexpr (Dims == 2) {
+            return StridedSlice<ValueType>(arr + ind*_stride[0], _shape[1], _stride[1]);
+        } else {
+            return NDSlice<ValueType, Dims - 1>(arr + ind*_stride[0], _shape + 1, _stride + 1);
+        }
+    }
+
+    NDSlice transpose(size_t axis1 = 0, size_t axis2 = 1) const {
+        if (axis1 >= Dims || axis2 >= Dims) throw InvalidView();
+        NDSlice res = *this;
+        std::swap(res._shape[axis1], res._shape[axis2]);
+        std::swap(res._stride[axis1], res._stride[axis2]);
+        return res;
+    }
+
+    void fill(const ValueType& val) {
+        ForEachLine([&val](Pointer line, SizeType n, SizeType step) {
+            if (step == 1) {
+                SimdKernels<ValueType>::fill(line, n, val);
+            } else {
+                for (SizeType i = 0; i < n; ++i) line[i*step] = val;
+            }
+        });
+    }
+
+    ValueType sum() const noexcept requires requires (ValueType a) { a += a; } {
+        ValueType res = ValueType();
+        ForEachLine([&res](Pointer line, SizeType n, SizeType step) {
+            if (step == 1) {
+                res += SimdKernels<ValueType>::sum(line, n);
+            } else {
+                for (SizeType i = 0; i < n; ++i) res += line[i*step];
+            }
+        });
+        return res;
+    }
+
+    // fill in row-major order, as many elements as both sides have
+    void operator=(const std::initializer_list<ValueType>& list) {
+        Assign(list.begin(), list.size());
+    }
+
+    template <TAllocator AlType, GrowthPolicy GrType>
+    void operator=(const Array<ValueType, AlType, GrType>& array) {
+        Assign(array.cbegin(), array.size());
+    }
+
+private:
+    Pointer arr;
+    SizeType _shape[Dims], _stride[Dims];
+
+    NDSlice(Pointer begin, const SizeType* shape, const SizeType* stride) : arr(begin) {
+        for (size_t d = 0; d < Dims; ++d) {
+            _shape[d] = shape[d];
+            _stride[d] = stride[d];
+        }
+    }
+
+    // calls f(first, length, step) for every line along the last axis, in row-major order
+    template <typename F>
+    void ForEachLine(F f) const {
+        for (size_t d = 0; d < Dims; ++d) {
+            if (_shape[d] == 0) return;
+        }
+        SizeType ind[Dims - 1] = {};
+        while (true) {
+            SizeType offset = 0;
+            for (size_t d = 0; d + 1 < Dims; ++d) offset += ind[d]*_stride[d];
+            f(arr + offset, _shape[Dims - 1], _stride[Dims - 1]);
+            size_t d = Dims - 1;
+            while (d > 0 && ++ind[d - 1] == _shape[d - 1]) {
+                ind[d - 1] = 0;
+                --d;
+            }
+            if (d == 0) return;
+        }
+    }
+
+    template <typename It>
+    void Assign(It it, SizeType n) {
+        ForEachLine([&it, &n](Pointer line, SizeType len, SizeType step) {
+            for (SizeType i = 0; i < len && n > 0; ++i, ++it, --n) {
+                line[i*step] = *it;
+            }
+        });
+    }
+};
+
 template <std::default_initializable VType,
-            TAllocator AlType = Allocator<VType>>
+            TAllocator AlType = Allocator<VType>,
+            GrowthPolicy GrType = DoubleGrowth>
 class Array {
 
 public:
@@ -439,25 +1137,32 @@ public:
     using ConstPointer          = const ValueType*;
     using ConstReference        = const ValueType&;
     using AllocatorType         = AlType;
+    using GrowthType            = GrType;
     using Iterator              = arrayIterator<ValueType>;
     using ConstIterator         = constArrayIterator<ValueType>;
     using SizeType              = typename Iterator::SizeType;
     using ItDiff                = typename Iterator::ItDiff;
     using SliceType             = Slice<ValueType>;
+    using StridedSliceType      = StridedSlice<ValueType>;
 
     static const SizeType default_capacity = 8;
 
 private:
     using AllocTraits       = AllocatorTraits<ValueType, AllocatorType>;
 
+    static constexpr SizeType initial_capacity = [] {
+        if constexpr (AllocTraits::has_inline_storage) return AllocatorType::inline_capacity;
+        else return default_capacity;
+    }();
+
 public:
 
-    Array() : _size(), alloc(), cap(default_capacity) {
+    Array() : _size(), alloc(), cap(initial_capacity) {
         arr = AllocTraits::allocate(alloc, cap);
     }
 
-    Array(SizeType n, const AllocatorType& alloc = AllocatorType()) : _size(n), cap(2*n), alloc(alloc) {
-        arr = AllocTraits::allocate(this->alloc, 2*n);
+    Array(SizeType n, const AllocatorType& alloc = AllocatorType()) : _size(n), cap(GrowthType::next(0, n)), alloc(alloc) {
+        arr = AllocTraits::allocate(this->alloc, cap);
         for (SizeType i = 0; i < n; i++) {
             AllocTraits::construct(this->alloc, arr + i);
         }
@@ -466,7 +1171,7 @@ public:
     template <IsArrayLike<ValueType> Vector>
     Array(const Vector& v, const AllocatorType& alloc = AllocatorType()) : alloc(alloc){
         _size = v.size();
-        cap = 2*_size;
+        cap = GrowthType::next(0, _size);
         arr = AllocTraits::allocate(this->alloc, cap);
         SizeType i = 0;
         for (auto it = v.cbegin(); it != v.cend(); ++it) {
@@ -476,7 +1181,7 @@ public:
     }
 
     template <SizeType len>
-    Array(const ValueType (&array)[len], const AllocatorType& alloc = AllocatorType()) : _size(len), cap(2*len), alloc(alloc){
+    Array(const ValueType (&array)[len], const AllocatorType& alloc = AllocatorType()) : _size(len), cap(GrowthType::next(0, len)), alloc(alloc){
         arr = AllocTraits::allocate(this->alloc, cap);
         for (SizeType i = 0; i < _size; ++i) {
             AllocTraits::construct(this->alloc, arr + i, array[i]);
@@ -485,7 +1190,7 @@ public:
 
     Array(const std::initializer_list<ValueType>& list, const AllocatorType& alloc = AllocatorType()) : alloc(alloc) {
         _size = list.size();
-        cap = 2*_size;
+        cap = GrowthType::next(0, _size);
         arr = AllocTraits::allocate(this->alloc, cap);
         SizeType i = 0;
         for (auto it = list.begin(); it != list.end(); ++it) {
@@ -494,23 +1199,35 @@ public:
         }
     }
 
-    Array(const Array& other) : alloc(alloc) {
+    Array(const Array& other) : alloc(other.alloc) {
         _size = other._size;
         cap = other.cap;
         alloc = other.alloc;
         arr = AllocTraits::allocate(alloc, cap);
         for (SizeType i = 0; i < _size; i++) {
-            AllocTraits::construct(alloc, arr + i, other.arr + i);
+            AllocTraits::construct(alloc, arr + i, *(other.arr + i));
         }
     }
 
     Array (Array&& other) : _size(other._size), alloc(other.alloc), cap(other.cap), arr(other.arr) {
-        other.arr = AllocTraits::allocate(alloc, default_capacity);
+        if constexpr (AllocTraits::has_inline_storage) {
+            // storage inside the other allocator can't be taken over, move the elements instead
+            if (other.alloc.owns(other.arr)) {
+                arr = AllocTraits::allocate(alloc, cap);
+                AllocTraits::relocate(alloc, arr, other.arr, _size);
+                other._size = 0;
+                return;
+            }
+        }
+        other.arr = AllocTraits::allocate(other.alloc, initial_capacity);
         other._size = 0;
-        other.cap = default_capacity;
+        other.cap = initial_capacity;
     }
 
     ~Array() {
+        if constexpr (AllocTraits::skip_teardown) {
+            return;
+        }
         for (SizeType i = 0; i < _size; ++i) {
             AllocTraits::destroy(alloc, arr + i);
         }
@@ -527,7 +1244,7 @@ public:
         }
         for (SizeType i = 0; i < other._size; ++i) {
             if (cap < other._size || i >= _size) {
-                AllocTraits::construct(alloc, arr + i, other.arr + i);
+                AllocTraits::construct(alloc, arr + i, *(other.arr + i));
             } else {
                 *(arr + i) = *(other.arr + i);
             }
@@ -538,13 +1255,32 @@ public:
         _size = other._size;
     }
     void operator= (Array&& other) {
+        if (this == &other) return;
         for (SizeType i = 0; i < _size; i++) {
             AllocTraits::destroy(alloc, arr + i);
         }
+        if constexpr (AllocTraits::has_inline_storage) {
+            // as in the move constructor, the other storage may live inside its allocator
+            if (other.alloc.owns(other.arr)) {
+                if (cap < other._size) {
+                    AllocTraits::deallocate(alloc, arr, cap);
+                    cap = other.cap;
+                    arr = AllocTraits::allocate(alloc, cap);
+                }
+                AllocTraits::relocate(alloc, arr, other.arr, other._size);
+                _size = other._size;
+                other._size = 0;
+                return;
+            }
+        }
         AllocTraits::deallocate(alloc, arr, cap);
+        alloc = other.alloc;
         arr = other.arr;
         _size = other._size;
         cap = other.cap;
+        other.arr = AllocTraits::allocate(other.alloc, initial_capacity);
+        other._size = 0;
+        other.cap = initial_capacity;
     }
     void operator= (const std::initializer_list<ValueType>& list) {
         if (cap < list.size()) {
@@ -552,7 +1288,7 @@ public:
                 AllocTraits::destroy(alloc, arr + i);
             }
             AllocTraits::deallocate(alloc, arr, cap);
-            arr = AllocTraits::allocate(alloc, 2*list.size());
+            arr = AllocTraits::allocate(alloc, GrowthType::next(cap, list.size()));
         }
         auto it = list.begin();
         for (SizeType i = 0; i < list.size(); ++i, ++it) {
@@ -563,7 +1299,7 @@ public:
             }
         }
         if (cap < list.size()) {
-            cap = 2*list.size();
+            cap = GrowthType::next(cap, list.size());
         }
         _size = list.size();
     }
@@ -575,7 +1311,7 @@ public:
                 AllocTraits::destroy(alloc, arr + i);
             }
             AllocTraits::deallocate(alloc, arr, cap);
-            arr = AllocTraits::allocate(alloc, 2*vec.size());
+            arr = AllocTraits::allocate(alloc, GrowthType::next(cap, vec.size()));
         }
         auto it = vec.cbegin();
         for (SizeType i = 0; i < vec.size(); ++i, ++it) {
@@ -586,7 +1322,7 @@ public:
             }
         }
         if (cap < vec.size()) {
-            cap = 2*vec.size();
+            cap = GrowthType::next(cap, vec.size());
         }
         _size = vec.size();
     }
@@ -598,7 +1334,7 @@ public:
                 AllocTraits::destroy(alloc, arr + i);
             }
             AllocTraits::deallocate(alloc, arr, cap);
-            arr = AllocTraits::allocate(alloc, 2*len);
+            arr = AllocTraits::allocate(alloc, GrowthType::next(cap, len));
         }
         for (SizeType i = 0; i < len; ++i) {
             if (cap < len || i >= _size) {
@@ -608,7 +1344,7 @@ public:
             }
         }
         if (cap < len) {
-            cap = 2*len;
+            cap = GrowthType::next(cap, len);
         }
         _size = len;
     }
@@ -626,7 +1362,7 @@ public:
     }
 
     ConstIterator cend() const noexcept {
-        return ConstIterator(begin, _size, _size);
+        return ConstIterator(arr, _size, _size);
     }
 
     SizeType size() const noexcept {
@@ -637,51 +1373,88 @@ public:
         return cap;
     }
 
-    std::enable_if_t<std::equality_comparable<ValueType>, bool> operator== (const Array& other) const noexcept {
-        if (_size != other._size) return false;
-        else {
-            for (SizeType i = 0; i < _size; ++i) {
-                if (*(arr + i) != *(other._arr + i)) {
-                    return false;
-                }
-            }
-            return true;
-        }
+    bool operator== (const Array& other) const noexcept requires std::equality_comparable<ValueType> {
+        return _size == other._size && SimdKernels<ValueType>::equal(arr, other.arr, _size);
     }
 
-    std::enable_if_t<std::equality_comparable<ValueType>, bool> operator!= (const Array& other) const noexcept {
-        if (_size != other._size) return true;
-        else {
-            for (SizeType i = 0; i < _size; ++i) {
-                if (*(arr + i) != *(other._arr + i)) {
-                    return true;
-                }
-            }
-            return false;
-        }
+    bool operator!= (const Array& other) const noexcept requires std::equality_comparable<ValueType> {
+        return !(*this == other);
+    }
+
+    // search, fill and reductions below run on SimdKernels, vectorized for arithmetic types
+
+    Iterator find(const ValueType& val) noexcept requires std::equality_comparable<ValueType> {
+        return Iterator(arr, _size, SimdKernels<ValueType>::find(arr, _size, val));
+    }
+
+    ConstIterator find(const ValueType& val) const noexcept requires std::equality_comparable<ValueType> {
+        return ConstIterator(arr, _size, SimdKernels<ValueType>::find(arr, _size, val));
+    }
+
+    SizeType count(const ValueType& val) const noexcept requires std::equality_comparable<ValueType> {
+        return SimdKernels<ValueType>::count(arr, _size, val);
+    }
+
+    bool contains(const ValueType& val) const noexcept requires std::equality_comparable<ValueType> {
+        return SimdKernels<ValueType>::find(arr, _size, val) != _size;
+    }
+
+    void fill(const ValueType& val) {
+        SimdKernels<ValueType>::fill(arr, _size, val);
+    }
+
+    ValueType min() const requires std::totally_ordered<ValueType> {
+        if (_size == 0) throw EmptyCollection();
+        return SimdKernels<ValueType>::min(arr, _size);
+    }
+
+    ValueType max() const requires std::totally_ordered<ValueType> {
+        if (_size == 0) throw EmptyCollection();
+        return SimdKernels<ValueType>::max(arr, _size);
+    }
+
+    ValueType sum() const noexcept requires requires (ValueType a) { a += a; } {
+        return SimdKernels<ValueType>::sum(arr, _size);
+    }
+
+    // stable LSD radix sort by key(element), which must be an integer or a float;
+    // the scratch buffer comes from the array's allocator
+    template <RadixKeyExtractor<ValueType> KeyFn = RadixIdentity>
+    void radix_sort(const KeyFn& key = KeyFn()) {
+        RadixKernels<ValueType, KeyFn>::lsd(arr, _size, key, alloc);
     }
 
-    template <std::constructible_from<ValueType> ...Args>
+    // MSD radix sort without extra memory, not stable
+    template <RadixKeyExtractor<ValueType> KeyFn = RadixIdentity>
+    void radix_sort_in_place(const KeyFn& key = KeyFn()) {
+        RadixKernels<ValueType, KeyFn>::msd(arr, _size, key);
+    }
+
+    template <typename... Args> requires std::constructible_from<ValueType, Args...>
     void emplace(const Iterator& where, Args&& ...args) {
         if (where.pos > _size) throw IteratorOutOfBounds();
+        if (where.pos == _size) {
+            emplace_back(std::forward<Args>(args)...);
+            return;
+        }
+        SizeType newcap = NextCapacity(_size + 1);
+        if (_size == cap && AllocTraits::expand(alloc, arr, cap, newcap)) {
+            cap = newcap;
+        }
         if (_size == cap) {
-            Pointer newarr = AllocTraits::allocate(alloc, cap*2);
-            for (SizeType i = 0; i < where.pos; ++i) {
-                AllocTraits::construct(alloc, newarr + i, std::move(*(arr + i)));
-            }
+            Pointer newarr = AllocTraits::allocate(alloc, newcap);
             AllocTraits::construct(alloc, newarr + where.pos, std::forward<Args>(args)...);
-            for (SizeType i = where.pos + 1; i < _size + 1; ++i) {
-                AllocTraits::construct(alloc, newarr + i, std::move(*(arr + i - 1)));
-            }
+            AllocTraits::relocate(alloc, newarr, arr, where.pos);
+            AllocTraits::relocate(alloc, newarr + where.pos + 1, arr + where.pos, _size - where.pos);
             AllocTraits::deallocate(alloc, arr, cap);
-            cap *= 2;
+            cap = newcap;
             ++_size;
             arr = newarr;
         } else {
-            for (SizeType i = _size; i > where.pos; --i) {
-                AllocTraits::construct(alloc, arr + i, std::move(*(arr + i - 1)));
-            }
-            AllocTraits::construct(alloc, arr + where.pos, std::forward<Args>(args)...);
+            // args may refer to an element that is about to shift, so build the value first
+            ValueType val(std::forward<Args>(args)...);
+            AllocTraits::relocate(alloc, arr + where.pos + 1, arr + where.pos, _size - where.pos);
+            AllocTraits::construct(alloc, arr + where.pos, std::move(val));
             ++_size;
         }
     }
@@ -691,26 +1464,24 @@ public:
         if (where.begin != arr || where.size != _size) throw AnotherIterator();
         SizeType addsize = 0;
         for (auto it = begin; it != end; ++it) {++addsize;}
+        SizeType newcap = NextCapacity(_size + addsize);
+        if (_size + addsize > cap && AllocTraits::expand(alloc, arr, cap, newcap)) {
+            cap = newcap;
+        }
         if (_size + addsize > cap) {
-            Pointer newarr = AllocTraits::allocate(alloc, cap + addsize);
-            SizeType i = 0;
-            for (; i < where.pos; ++i) {
-                AllocTraits::construct(alloc, newarr + i, std::move(*(arr + i)));
-            }
+            Pointer newarr = AllocTraits::allocate(alloc, newcap);
+            SizeType i = where.pos;
             for (auto it = begin; it != end; ++it, ++i) {
                 AllocTraits::construct(alloc, newarr + i, *it);
             }
-            for (; i < _size + addsize; ++i) {
-                AllocTraits::construct(alloc, newarr + i, std::move(*(arr + i - addsize)));
-            }
+            AllocTraits::relocate(alloc, newarr, arr, where.pos);
+            AllocTraits::relocate(alloc, newarr + where.pos + addsize, arr + where.pos, _size - where.pos);
             AllocTraits::deallocate(alloc, arr, cap);
             arr = newarr;
-            cap += addsize;
+            cap = newcap;
             _size += addsize;
         } else {
-            for (SizeType i = addsize + _size - 1; i >= where.pos + addsize; --i) {
-                AllocTraits::construct(alloc, arr + i, std::move(*(arr + i - addsize)));
-            }
+            AllocTraits::relocate(alloc, arr + where.pos + addsize, arr + where.pos, _size - where.pos);
             SizeType i = where.pos;
             for (auto it = begin; it != end; ++it, ++i) {
                 AllocTraits::construct(alloc, arr + i, *it);
@@ -719,12 +1490,27 @@ public:
         }
     }
 
+    // amortized O(1): capacity grows geometrically (with the default policy)
+    // and only when the array is full
+    template <typename... Args> requires std::constructible_from<ValueType, Args...>
+    Reference emplace_back(Args&&... args) {
+        if (_size == cap) {
+            // args may refer to an element of this array, so build the value before moving storage
+            ValueType val(std::forward<Args>(args)...);
+            reserve(NextCapacity(_size + 1));
+            AllocTraits::construct(alloc, arr + _size, std::move(val));
+        } else {
+            AllocTraits::construct(alloc, arr + _size, std::forward<Args>(args)...);
+        }
+        return *(arr + _size++);
+    }
+
     void append(const ValueType& val) {
-        emplace(end(), val);
+        emplace_back(val);
     }
 
     void append(ValueType&& val) {
-        emplace(end(), std::move(val));
+        emplace_back(std::move(val));
     }
 
     void pop() {
@@ -732,52 +1518,114 @@ public:
     }
 
     void erase(const Iterator& begin, const Iterator& end, SizeType step=1) {
-        if (begin.pos >= _size || end.pos >= _size) throw IteratorOutOfBounds();
-        else if (begin > end) return;
+        if (begin.pos >= _size || end.pos > _size) throw IteratorOutOfBounds();
+        else if (begin.pos >= end.pos) return;
         else {
-            SizeType deleted = 0;
-            for (SizeType i = begin.pos; i < _size; ++i) {
-                if (i % step == begin.pos % step && i < end.pos) {
-                    ++deleted;
-                    AllocTraits::destroy(alloc, arr + i);
-                } else {
-                    AllocTraits::construct(alloc, arr + i - deleted, std::move(*(arr + i)));
-                }
+            // every step-th element of [begin, end) goes away,
+            // survivors between them are shifted left run by run
+            SizeType deleted = 0, i = begin.pos;
+            for (; i < end.pos; i += step) {
+                AllocTraits::destroy(alloc, arr + i);
+                ++deleted;
+                SizeType run_end = (i + step < end.pos ? i + step : end.pos);
+                AllocTraits::relocate(alloc, arr + i + 1 - deleted, arr + i + 1, run_end - i - 1);
             }
+            AllocTraits::relocate(alloc, arr + end.pos - deleted, arr + end.pos, _size - end.pos);
             _size -= deleted;
         }
     }
 
+    // removes the elements satisfying pred in one pass and returns how many went away;
+    // every survivor is moved at most once, runs of them with a single memmove when relocatable
+    template <std::predicate<const ValueType&> Pred>
+    SizeType erase_if(Pred pred) {
+        return Compact([&pred](ConstPointer cur, ConstPointer) { return pred(*cur); });
+    }
+
+    // erases right away, as List::remove_if does; leaving moved-from elements behind
+    // would only cost an element-wise move per survivor and a second pass to trim them
+    template <std::predicate<const ValueType&> Pred>
+    SizeType remove_if(Pred pred) {
+        return erase_if(pred);
+    }
+
+    // removes every element equal to the one kept before it, returns how many went away
+    template <typename Eq = std::equal_to<ValueType>> requires std::predicate<Eq, const ValueType&, const ValueType&>
+    SizeType unique(Eq eq = Eq()) {
+        return Compact([&eq](ConstPointer cur, ConstPointer last) { return last && eq(*last, *cur); });
+    }
+
     void reserve(SizeType n) {
         if (n <= cap) {
             return;
         } else {
-            Pointer newarr = AllocTraits::allocate(alloc, n);
-            for (SizeType i = 0; i < _size; ++i) {
-                AllocTraits::construct(alloc, newarr + i, std::move(*(arr + i)));
-            }
-            AllocTraits::deallocate(alloc, arr, cap);
-            arr = newarr;
+            arr = AllocTraits::reallocate(alloc, arr, cap, n, _size);
             cap = n;
         }
     }
 
     void shrink_to_fit() {
-        if (cap == _size) return;
-        Pointer newarr = AllocTraits::allocate(alloc, _size);
-        for (SizeType i = 0; i < _size; ++i) {
-            AllocTraits::construct(alloc, newarr + i, std::move(*(arr + i)));
+        if constexpr (AllocTraits::has_inline_storage) {
+            // the inline buffer costs nothing to keep, and a heap block that fits in it moves back
+            if (alloc.owns(arr)) return;
+            if (_size <= AllocatorType::inline_capacity) {
+                Pointer buf = AllocTraits::allocate(alloc, AllocatorType::inline_capacity);
+                AllocTraits::relocate(alloc, buf, arr, _size);
+                AllocTraits::deallocate(alloc, arr, cap);
+                arr = buf;
+                cap = AllocatorType::inline_capacity;
+                return;
+            }
         }
-        AllocTraits::deallocate(alloc, arr, cap);
-        arr = newarr;
+        if (cap == _size) return;
+        arr = AllocTraits::reallocate(alloc, arr, cap, _size, _size);
         cap = _size;
     }
 
-    ValueType& operator[](ItDiff ind) noexcept {
+    // binary snapshot (see snapshot.hpp); arrays of raw elements take a single write and read
+    void save(std::ostream& out) const requires Serializable<ValueType> {
+        SnapshotHeader::write(out, SnapshotKind::Array, snapshot_value_size<ValueType>, _size);
+        Serializer<ValueType>::write(out, arr, _size);
+    }
+
+    // reads into a new array and takes it over only when the whole snapshot has been read,
+    // so a corrupt or truncated stream throws SnapshotError and leaves this array as it was
+    void load(std::istream& in) requires Serializable<ValueType> {
+        uint64_t n = SnapshotHeader::read(in, SnapshotKind::Array, snapshot_value_size<ValueType>);
+        Array loaded(0, alloc);
+        loaded.reserve(snapshot_reserve(in, n, snapshot_value_size<ValueType>));
+        while (loaded._size < n) {
+            if (loaded._size == loaded.cap) loaded.reserve(loaded.NextCapacity(loaded._size + 1));
+            SizeType first = loaded._size;
+            SizeType k = std::min<uint64_t>(n - first, loaded.cap - first);
+            if constexpr (Serializer<ValueType>::raw) {
+                Serializer<ValueType>::read(in, loaded.arr + first, k);
+                loaded._size += k;
+            } else {
+                for (; loaded._size < first + k; ++loaded._size) {
+                    AllocTraits::construct(loaded.alloc, loaded.arr + loaded._size);
+                }
+                Serializer<ValueType>::read(in, loaded.arr + first, k);
+            }
+        }
+        *this = std::move(loaded);
+    }
+
+    // index taken modulo size, negative indices count from the end
+    ValueType& at(ItDiff ind) noexcept {
         if (ind >= 0) {
             return *(arr + (ind % _size));
         } else {
-            return *(arr + (_size + ind % _size) % _size);
+            return *(arr + (_size + ind % ItDiff(_size)) % _size);
+        }
+    }
+
+    // wraps like at() in checked mode, plain offset in unchecked mode
+    ValueType& operator[](ItDiff ind) noexcept {
+        if constexpr (checked_access) {
+            return at(ind);
+        } else {
+            return *(arr + ind);
         }
     }
 
@@ -785,9 +1633,61 @@ public:
         if (from > to) return Slice(arr + _size, 0);
         else return Slice(arr + from, to - from);
     }
+
+    // every step-th element of [from, to), as Array::erase takes them
+    StridedSliceType slice(SizeType from, SizeType to, SizeType step) {
+        return StridedSliceType(arr, _size, 1).slice(from, to, step);
+    }
+
+    // the first elements seen as a row-major array of the given shape
+    template <size_t Dims> requires (Dims >= 2)
+    NDSlice<ValueType, Dims> view(const SizeType (&shape)[Dims]) {
+        return NDSlice<ValueType, Dims>(arr, shape, RowMajor(_size, shape).stride);
+    }
 private:
+    SizeType NextCapacity(SizeType required) const noexcept {
+        return GrowthType::next(cap, required);
+    }
+
+    // drops the elements for which drop(element, last kept element or nullptr) holds:
+    // they are destroyed on the spot and the run of survivors before each of them is
+    // relocated behind the ones kept so far
+    template <typename Drop>
+    SizeType Compact(Drop drop) {
+        // survivors [run, i) are still to be moved to kept
+        SizeType kept = 0, run = 0, i = 0;
+        try {
+            for (; i < _size; ++i) {
+                ConstPointer last = (i > run ? arr + i - 1 : kept > 0 ? arr + kept - 1 : nullptr);
+                if (!drop(arr + i, last)) continue;
+                AllocTraits::relocate(alloc, arr + kept, arr + run, i - run);
+                kept += i - run;
+                AllocTraits::destroy(alloc, arr + i);
+                run = i + 1;
+            }
+        } catch (...) {
+            AllocTraits::relocate(alloc, arr + kept, arr + run, _size - run);
+            _size = kept + (_size - run);
+            throw;
+        }
+        AllocTraits::relocate(alloc, arr + kept, arr + run, _size - run);
+        kept += _size - run;
+        SizeType removed = _size - kept;
+        _size = kept;
+        return removed;
+    }
+
     Pointer arr;
     SizeType _size, cap;
     AllocatorType alloc;
 
 };
+
+// Array keeping up to N elements inside the object itself; the heap (AlType) is used
+// only once it grows past N
+template <std::default_initializable VType,
+            size_t N,
+            TAllocator AlType = Allocator<VType>,
+            GrowthPolicy GrType = DoubleGrowth>
+using SmallArray = Array<VType, InlineAllocator<VType, N, AlType>, GrType>;
+
@@ -0,0 +1,37 @@
+// g++ -std=c++20 -O2 -I. bench/aligned_allocator.cpp -o aligned_allocator && ./aligned_allocator [MiB]
+//
+// Sums an Array of 1 GiB of uint64_t, first in order and then at random indices, with its
+// storage from the default Allocator and from AlignedAllocator (huge pages). The random
+// scan is where the TLB misses of 4 KiB pages show.
+
+#include "bench/bench.hpp"
+#include "array.hpp"
+#include <bit>
+
+template <TAllocator AlType>
+void run(const char* name, size_t n) {
+    Array<uint64_t, AlType> arr(n);
+    for (size_t i = 0; i < n; ++i) arr[i] = i;
+    uint64_t sum = 0;
+    double seq = measure([&] {
+        for (size_t i = 0; i < n; ++i) sum += arr[i];
+    });
+    keep(sum);
+    BenchRandom rnd;
+    double rand = measure([&] {
+        for (size_t i = 0; i < n; ++i) sum += arr[rnd() & (n - 1)];
+    });
+    keep(sum);
+    char label[64];
+    std::snprintf(label, sizeof(label), "%s sequential", name);
+    report(label, n, seq);
+    std::snprintf(label, sizeof(label), "%s random", name);
+    report(label, n, rand);
+}
+
+int main(int argc, char** argv) {
+    // a power of two, so that random indices can be masked
+    size_t n = std::bit_floor(bench_size(argc, argv, 1024) << 20) / sizeof(uint64_t);
+    run<Allocator<uint64_t>>("Allocator", n);
+    run<AlignedAllocator<uint64_t>>("AlignedAllocator", n);
+}
@@ -0,0 +1,36 @@
+// g++ -std=c++20 -O2 -I. bench/append.cpp -o append && ./append [n]
+//
+// Appends n ints to an empty Array with each growth policy, and to a std::vector for
+// reference. Storage comes through StatsAllocator, so next to the time it reports how
+// many times the buffer was (re)allocated and the peak memory held.
+
+#include "bench/bench.hpp"
+#include "array.hpp"
+#include <vector>
+
+template <GrowthPolicy GrType, typename Tag>
+void run(const char* name, size_t n) {
+    using AlType = StatsAllocator<Allocator<int>, Tag>;
+    AllocationStats& stats = AlType::stats();
+    stats.reset();
+    double time = measure([&] {
+        Array<int, AlType, GrType> arr;
+        for (size_t i = 0; i < n; ++i) arr.append(int(i));
+        keep(arr);
+    });
+    report(name, n, time);
+    std::printf("%40s %12zu allocations, peak %zu KiB\n", "", stats.allocations(), stats.peak_bytes() >> 10);
+}
+
+int main(int argc, char** argv) {
+    size_t n = bench_size(argc, argv, 10000000);
+    run<DoubleGrowth, struct Double>("DoubleGrowth", n);
+    run<HalfGrowth, struct Half>("HalfGrowth", n);
+    run<StepGrowth<4096>, struct Step>("StepGrowth<4096>", n);
+    double time = measure([&] {
+        std::vector<int> vec;
+        for (size_t i = 0; i < n; ++i) vec.push_back(int(i));
+        keep(vec);
+    });
+    report("std::vector", n, time);
+}
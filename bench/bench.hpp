@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// Shared bits of the benchmarks in this directory. Each benchmark is a single .cpp file
+// built on its own with the command given at its top, run from the repository root.
+
+// wall-clock seconds taken by f()
+template <typename F>
+double measure(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// keeps the optimizer from dropping a value nothing else reads
+template <typename T>
+void keep(const T& val) {
+    asm volatile("" : : "r"(&val) : "memory");
+}
+
+// the problem size, the first command line argument if there is one
+inline size_t bench_size(int argc, char** argv, size_t fallback) {
+    return (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : fallback);
+}
+
+// xorshift64, fast enough not to show up in the timings
+struct BenchRandom {
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    uint64_t operator() () noexcept {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+inline void report(const char* name, size_t ops, double seconds) {
+    std::printf("%-40s %12zu ops %10.3f ms %10.2f ns/op\n", name, ops, seconds * 1e3, seconds * 1e9 / ops);
+}
@@ -0,0 +1,159 @@
+// g++ -std=c++20 -O2 -I. bench/boundedqueue.cpp -pthread -o boundedqueue && ./boundedqueue [n] [threads]
+//
+// Throughput: n values pass from producers to consumers through an SPSCQueue (one at a
+// time and in batches of 64), an MPMCQueue and, for comparison, a List behind a mutex;
+// first with one producer and one consumer, then, for the MPMC queue and the List, with
+// threads/2 of each (all cores by default). Latency: one value bounces between two
+// threads through a pair of queues, and the percentiles of the round trip are reported.
+// With fewer cores than threads the numbers mostly measure the scheduler.
+
+#include "bench/bench.hpp"
+#include "boundedqueue.hpp"
+#include "list.hpp"
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+constexpr size_t queue_capacity = 1 << 12;
+constexpr size_t batch = 64;
+
+// List behind a mutex with the queues' try_push/try_pop, what the queues replace
+struct LockedList {
+    List<uint64_t> list;
+    std::mutex lock;
+
+    bool try_push(uint64_t val) {
+        std::lock_guard<std::mutex> guard(lock);
+        list.append(val);
+        return true;
+    }
+
+    bool try_pop(uint64_t& out) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (list.size() == 0) return false;
+        out = list.front();
+        list.pop_front();
+        return true;
+    }
+};
+
+// runs producers pushing n values in total and consumers popping them, returns the seconds
+// taken; push(queue, first, count) and pop(queue, out, max) move as many as they can
+template <typename Queue, typename Push, typename Pop>
+double transfer(Queue& queue, size_t n, unsigned producers, unsigned consumers, Push push, Pop pop) {
+    std::atomic<size_t> popped = 0;
+    std::atomic<uint64_t> checksum = 0;
+    double time = measure([&] {
+        std::vector<std::thread> pool;
+        for (unsigned p = 0; p < producers; ++p) {
+            pool.emplace_back([&, p] {
+                size_t from = n * p / producers, to = n * (p + 1) / producers;
+                while (from < to) {
+                    size_t k = push(queue, from, to - from);
+                    if (k == 0) std::this_thread::yield();
+                    from += k;
+                }
+            });
+        }
+        for (unsigned c = 0; c < consumers; ++c) {
+            pool.emplace_back([&] {
+                uint64_t buf[batch], sum = 0;
+                while (popped.load(std::memory_order_relaxed) < n) {
+                    size_t k = pop(queue, buf, batch);
+                    if (k == 0) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    for (size_t i = 0; i < k; ++i) sum += buf[i];
+                    popped.fetch_add(k, std::memory_order_relaxed);
+                }
+                checksum.fetch_add(sum, std::memory_order_relaxed);
+            });
+        }
+        for (auto& thread : pool) thread.join();
+    });
+    if (checksum.load() != uint64_t(n) * (n - 1) / 2) std::printf("values lost\n");
+    return time;
+}
+
+auto push_one = [](auto& queue, size_t first, size_t) -> size_t {
+    return queue.try_push(uint64_t(first));
+};
+
+auto pop_one = [](auto& queue, uint64_t* out, size_t) -> size_t {
+    return queue.try_pop(*out);
+};
+
+auto push_batch = [](auto& queue, size_t first, size_t count) -> size_t {
+    uint64_t buf[batch];
+    size_t k = std::min(count, batch);
+    for (size_t i = 0; i < k; ++i) buf[i] = first + i;
+    return queue.try_push(buf, k);
+};
+
+auto pop_batch = [](auto& queue, uint64_t* out, size_t max) -> size_t {
+    return queue.try_pop(out, max);
+};
+
+// round trips of one value between this thread and an echoing one
+template <typename Queue>
+void latency(const char* name, size_t rounds) {
+    Queue there(queue_capacity), back(queue_capacity);
+    std::thread echo([&] {
+        uint64_t val;
+        for (size_t i = 0; i < rounds; ++i) {
+            while (!there.try_pop(val)) std::this_thread::yield();
+            while (!back.try_push(val)) std::this_thread::yield();
+        }
+    });
+    std::vector<double> rtt(rounds);
+    uint64_t val;
+    for (size_t i = 0; i < rounds; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        there.push(i);
+        while (!back.try_pop(val)) std::this_thread::yield();
+        rtt[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+    echo.join();
+    std::sort(rtt.begin(), rtt.end());
+    std::printf("%-40s round trip p50 %.0f ns, p99 %.0f ns, max %.0f ns\n", name,
+                rtt[rounds / 2], rtt[rounds * 99 / 100], rtt[rounds - 1]);
+}
+
+int main(int argc, char** argv) {
+    size_t n = bench_size(argc, argv, 10000000);
+    unsigned threads = (argc > 2 ? std::atoi(argv[2]) : std::thread::hardware_concurrency());
+    unsigned half = std::max(1u, threads / 2);
+    char label[64];
+
+    {
+        SPSCQueue<uint64_t> queue(queue_capacity);
+        report("SPSCQueue 1P1C", n, transfer(queue, n, 1, 1, push_one, pop_one));
+    }
+    {
+        SPSCQueue<uint64_t> queue(queue_capacity);
+        report("SPSCQueue 1P1C, batches of 64", n, transfer(queue, n, 1, 1, push_batch, pop_batch));
+    }
+    for (unsigned k : {1u, half}) {
+        {
+            MPMCQueue<uint64_t> queue(queue_capacity);
+            std::snprintf(label, sizeof(label), "MPMCQueue %uP%uC", k, k);
+            report(label, n, transfer(queue, n, k, k, push_one, pop_one));
+        }
+        {
+            MPMCQueue<uint64_t> queue(queue_capacity);
+            std::snprintf(label, sizeof(label), "MPMCQueue %uP%uC, batches of 64", k, k);
+            report(label, n, transfer(queue, n, k, k, push_batch, pop_batch));
+        }
+        {
+            LockedList queue;
+            std::snprintf(label, sizeof(label), "List with a mutex %uP%uC", k, k);
+            report(label, n, transfer(queue, n, k, k, push_one, pop_one));
+        }
+        if (half == 1) break;
+    }
+
+    size_t rounds = std::max<size_t>(n / 100, 1);
+    latency<SPSCQueue<uint64_t>>("SPSCQueue", rounds);
+    latency<MPMCQueue<uint64_t>>("MPMCQueue", rounds);
+}
@@ -0,0 +1,54 @@
+// g++ -std=c++20 -O2 -I. bench/concurrentarray.cpp -pthread -o concurrentarray && ./concurrentarray [n] [threads]
+//
+// Appends n ints in total, split evenly between 1 up to as many threads as there are
+// cores (or the second argument), into one ConcurrentArray and, for comparison, into one
+// Array behind a mutex.
+
+#include "bench/bench.hpp"
+#include "array.hpp"
+#include "concurrentarray.hpp"
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+template <typename F>
+double parallel(unsigned threads, F f) {
+    return measure([&] {
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; ++t) pool.emplace_back(f, t);
+        for (auto& thread : pool) thread.join();
+    });
+}
+
+int main(int argc, char** argv) {
+    size_t n = bench_size(argc, argv, 10000000);
+    unsigned cores = (argc > 2 ? std::atoi(argv[2]) : std::thread::hardware_concurrency());
+    cores = std::max(1u, cores);
+
+    for (unsigned threads = 1;; threads = std::min(2 * threads, cores)) {
+        size_t per_thread = n / threads;
+        char label[64];
+
+        ConcurrentArray<int> concurrent;
+        double time = parallel(threads, [&](unsigned t) {
+            for (size_t i = 0; i < per_thread; ++i) concurrent.append(int(t));
+        });
+        std::snprintf(label, sizeof(label), "ConcurrentArray, %u threads", threads);
+        report(label, per_thread * threads, time);
+        if (concurrent.size() != per_thread * threads) std::printf("lost appends\n");
+
+        Array<int> locked;
+        std::mutex lock;
+        time = parallel(threads, [&](unsigned t) {
+            for (size_t i = 0; i < per_thread; ++i) {
+                std::lock_guard<std::mutex> guard(lock);
+                locked.append(int(t));
+            }
+        });
+        std::snprintf(label, sizeof(label), "Array with a mutex, %u threads", threads);
+        report(label, per_thread * threads, time);
+
+        if (threads == cores) break;
+    }
+}
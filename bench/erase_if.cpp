@@ -0,0 +1,56 @@
+// g++ -std=c++20 -O2 -I. bench/erase_if.cpp -o erase_if && ./erase_if [n]
+//
+// Filters out a random half of n elements (10M by default) with Array::erase_if, for
+// ints and for strings, and with List::erase_if. For reference it also erases matching
+// ints one at a time, the O(n^2) way, on n/100 elements only.
+
+#include "bench/bench.hpp"
+#include "array.hpp"
+#include "list.hpp"
+#include <string>
+
+bool odd(int x) noexcept {
+    return x & 1;
+}
+
+bool odd_string(const std::string& s) noexcept {
+    return s.back() & 1;
+}
+
+template <typename T, typename Pred>
+void run(const char* name, const Array<T>& input, Pred pred) {
+    char label[64];
+    Array<T> arr = input;
+    double time = measure([&] { keep(arr.erase_if(pred)); });
+    std::snprintf(label, sizeof(label), "%s erase_if", name);
+    report(label, input.size(), time);
+}
+
+int main(int argc, char** argv) {
+    size_t n = bench_size(argc, argv, 10000000);
+    BenchRandom rnd;
+
+    Array<int> ints(n);
+    for (size_t i = 0; i < n; ++i) ints[i] = int(rnd());
+    run("Array<int>", ints, odd);
+
+    Array<std::string> strings(n);
+    for (size_t i = 0; i < n; ++i) strings[i] = std::to_string(ints[i]);
+    run("Array<std::string>", strings, odd_string);
+
+    List<int> list;
+    for (size_t i = 0; i < n; ++i) list.append(ints[i]);
+    double time = measure([&] { keep(list.erase_if(odd)); });
+    report("List<int> erase_if", n, time);
+
+    size_t m = n / 100;
+    Array<int> arr(m);
+    for (size_t i = 0; i < m; ++i) arr[i] = ints[i];
+    time = measure([&] {
+        for (size_t i = 0; i < arr.size();) {
+            if (odd(arr[i])) arr.erase(arr.begin() + i, arr.begin() + i + 1);
+            else ++i;
+        }
+    });
+    report("Array<int> erase one by one", m, time);
+}
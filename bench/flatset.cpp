@@ -0,0 +1,54 @@
+// g++ -std=c++20 -O2 -I. bench/flatset.cpp -o flatset && ./flatset [n]
+//
+// Builds a FlatSet and a Set of the same n random ints, then times random lookups (half
+// of them hits), lower_bound, and a full in-order iteration of each.
+
+#include "bench/bench.hpp"
+#include "flatset.hpp"
+#include <vector>
+
+template <typename Container>
+void run(const char* name, const Array<int>& keys, const std::vector<int>& probes) {
+    char label[64];
+    Container set;
+    double build = measure([&] { set.insert(keys.cbegin(), keys.cend()); });
+    size_t hits = 0;
+    double find = measure([&] {
+        for (int key : probes) hits += set.contains(key);
+    });
+    keep(hits);
+    long long sum = 0;
+    double bound = measure([&] {
+        for (int key : probes) {
+            auto it = set.lower_bound(key);
+            if (it != set.cend()) sum += *it;
+        }
+    });
+    keep(sum);
+    const int rounds = 10;
+    double iterate = measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            for (auto it = set.cbegin(); it != set.cend(); ++it) sum += *it;
+        }
+    });
+    keep(sum);
+    std::snprintf(label, sizeof(label), "%s build", name);
+    report(label, keys.size(), build);
+    std::snprintf(label, sizeof(label), "%s contains", name);
+    report(label, probes.size(), find);
+    std::snprintf(label, sizeof(label), "%s lower_bound", name);
+    report(label, probes.size(), bound);
+    std::snprintf(label, sizeof(label), "%s iteration", name);
+    report(label, rounds * set.size(), iterate);
+}
+
+int main(int argc, char** argv) {
+    size_t n = bench_size(argc, argv, 1000000);
+    BenchRandom rnd;
+    Array<int> keys(n);
+    std::vector<int> probes(n);
+    for (size_t i = 0; i < n; ++i) keys[i] = int(rnd() % (2 * n));
+    for (size_t i = 0; i < n; ++i) probes[i] = int(rnd() % (2 * n));
+    run<FlatSet<int>>("FlatSet<int>", keys, probes);
+    run<Set<int>>("Set<int>", keys, probes);
+}
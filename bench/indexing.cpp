@@ -0,0 +1,50 @@
+// g++ -std=c++20 -O2 -I. bench/indexing.cpp -o indexing_checked && ./indexing_checked [n]
+// g++ -std=c++20 -O2 -DUNCHECKED_ACCESS -I. bench/indexing.cpp -o indexing_unchecked && ./indexing_unchecked [n]
+//
+// Sums n ints through Array::operator[], Slice::operator[], Array::at() and a raw pointer.
+// Build it once in each mode and compare: operator[] wraps its index like at() in the
+// checked build and is a plain offset in the unchecked one.
+
+#include "bench/bench.hpp"
+#include "array.hpp"
+
+int main(int argc, char** argv) {
+    size_t n = bench_size(argc, argv, 10000000);
+    const int rounds = 10;
+    Array<int> arr(n);
+    for (size_t i = 0; i < n; ++i) arr[i] = int(i);
+    auto slice = arr.slice(0, n);
+    int* data = &*arr.begin();
+    long long sum = 0;
+
+    double raw = measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < n; ++i) sum += data[i];
+        }
+    });
+    keep(sum);
+    double index = measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < n; ++i) sum += arr[i];
+        }
+    });
+    keep(sum);
+    double slice_index = measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < n; ++i) sum += slice[i];
+        }
+    });
+    keep(sum);
+    double at = measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < n; ++i) sum += arr.at(i);
+        }
+    });
+    keep(sum);
+
+    std::printf("%s build\n", (checked_access ? "checked" : "unchecked"));
+    report("raw pointer", rounds * n, raw);
+    report("Array::operator[]", rounds * n, index);
+    report("Slice::operator[]", rounds * n, slice_index);
+    report("Array::at", rounds * n, at);
+}
@@ -0,0 +1,90 @@
+// g++ -std=c++20 -O2 -I. bench/iterators.cpp -o iterators && ./iterators [n]
+//
+// Sums n ints through Array's iterators, through a copy of the virtual iterator hierarchy
+// iterators.hpp used to have, and through a raw pointer. The virtual loop takes the base
+// class by reference, as generic code over the old hierarchy had to, and is kept out of
+// line so the compiler can't see the dynamic type and devirtualize it. Add
+// -DUNCHECKED_ACCESS to compare against the unchecked iterators.
+
+#include "bench/bench.hpp"
+#include "array.hpp"
+#include <vector>
+
+namespace legacy {
+
+// the old ForwardIterator, with its pure virtual operations
+template <typename VType>
+class ForwardIterator {
+public:
+    virtual VType& operator*() const = 0;
+    virtual bool operator==(const ForwardIterator&) const noexcept = 0;
+    virtual bool operator!=(const ForwardIterator&) const noexcept = 0;
+    virtual ForwardIterator& operator++() = 0;
+};
+
+template <typename VType>
+class PointerIterator : public ForwardIterator<VType> {
+public:
+    explicit PointerIterator(VType* ptr) : ptr(ptr) {}
+
+    VType& operator*() const override {
+        return *ptr;
+    }
+
+    bool operator==(const ForwardIterator<VType>& it) const noexcept override {
+        return ptr == static_cast<const PointerIterator&>(it).ptr;
+    }
+
+    bool operator!=(const ForwardIterator<VType>& it) const noexcept override {
+        return !(*this == it);
+    }
+
+    PointerIterator& operator++() override {
+        ++ptr;
+        return *this;
+    }
+
+private:
+    VType* ptr;
+};
+
+}
+
+[[gnu::noinline]] long long sum_virtual(legacy::ForwardIterator<int>& it, const legacy::ForwardIterator<int>& end) {
+    long long sum = 0;
+    for (; it != end; ++it) sum += *it;
+    return sum;
+}
+
+int main(int argc, char** argv) {
+    size_t n = bench_size(argc, argv, 10000000);
+    const int rounds = 10;
+    Array<int> arr(n);
+    for (size_t i = 0; i < n; ++i) arr[i] = int(i);
+    int* data = &*arr.begin();
+    long long sum = 0;
+
+    double raw = measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            for (int* p = data; p != data + n; ++p) sum += *p;
+        }
+    });
+    keep(sum);
+    double concrete = measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            for (auto it = arr.begin(); it != arr.end(); ++it) sum += *it;
+        }
+    });
+    keep(sum);
+    double virt = measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            legacy::PointerIterator<int> it(data), end(data + n);
+            sum += sum_virtual(it, end);
+        }
+    });
+    keep(sum);
+
+    report("raw pointer", rounds * n, raw);
+    report("Array iterator", rounds * n, concrete);
+    report("virtual iterator", rounds * n, virt);
+}
@@ -0,0 +1,75 @@
+// g++ -std=c++20 -O2 -I. bench/mappedarray.cpp -o mappedarray && ./mappedarray [MiB] [path]
+//
+// Writes a file of doubles (256 MiB, in /tmp by default) and compares reading it into an
+// Array with opening it as a MappedArray: the time until the array is usable, and the
+// time until it has been summed once. Cold runs first drop the file from the page cache
+// with posix_fadvise, warm runs find it there.
+
+#include "bench/bench.hpp"
+#include "mappedarray.hpp"
+#include <cstdio>
+#include <optional>
+
+void drop_cache(const char* path) {
+    int fd = ::open(path, O_RDONLY);
+    ::fdatasync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+template <typename Arr>
+double sum(Arr& arr, size_t n) {
+    double res = 0;
+    for (size_t i = 0; i < n; ++i) res += arr[i];
+    return res;
+}
+
+void run(const char* path, size_t n, bool cold) {
+    const char* temp = (cold ? "cold" : "warm");
+    char label[64];
+
+    if (cold) drop_cache(path);
+    double load = 0, scan = 0;
+    {
+        Array<double> arr;
+        load = measure([&] {
+            FILE* file = std::fopen(path, "rb");
+            double val;
+            while (std::fread(&val, sizeof(val), 1, file) == 1) arr.append(val);
+            std::fclose(file);
+        });
+        scan = measure([&] { keep(sum(arr, n)); });
+    }
+    std::snprintf(label, sizeof(label), "Array load, %s", temp);
+    report(label, n, load);
+    std::snprintf(label, sizeof(label), "Array first scan, %s", temp);
+    report(label, n, scan);
+
+    if (cold) drop_cache(path);
+    {
+        std::optional<MappedArray<double>> mapped;
+        load = measure([&] { mapped.emplace(path); });
+        scan = measure([&] { keep(sum(*mapped, n)); });
+    }
+    std::snprintf(label, sizeof(label), "MappedArray open, %s", temp);
+    report(label, n, load);
+    std::snprintf(label, sizeof(label), "MappedArray first scan, %s", temp);
+    report(label, n, scan);
+}
+
+int main(int argc, char** argv) {
+    size_t n = (bench_size(argc, argv, 256) << 20) / sizeof(double);
+    const char* path = (argc > 2 ? argv[2] : "/tmp/mappedarray.bench");
+    {
+        FILE* file = std::fopen(path, "wb");
+        if (!file) return 1;
+        for (size_t i = 0; i < n; ++i) {
+            double val = double(i);
+            std::fwrite(&val, sizeof(val), 1, file);
+        }
+        std::fclose(file);
+    }
+    run(path, n, true);
+    run(path, n, false);
+    std::remove(path);
+}
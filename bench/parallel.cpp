@@ -0,0 +1,36 @@
+// g++ -std=c++20 -O2 -I. bench/parallel.cpp -pthread -o parallel && ./parallel [n] [threads]
+//
+// Runs each Parallel algorithm over an Array of n random ints with 1 thread and then
+// doubling up to as many threads as there are cores (or the second argument), to show
+// how they scale.
+
+#include "bench/bench.hpp"
+#include "parallel.hpp"
+
+int main(int argc, char** argv) {
+    size_t n = bench_size(argc, argv, 10000000);
+    unsigned cores = (argc > 2 ? std::atoi(argv[2]) : std::thread::hardware_concurrency());
+    cores = std::max(1u, cores);
+    Array<int> input(n), arr(n);
+    Array<long long> wide(n);
+    BenchRandom rnd;
+    for (size_t i = 0; i < n; ++i) input[i] = int(rnd() >> 33);
+
+    for (unsigned threads = 1;; threads = std::min(2 * threads, cores)) {
+        Parallel par(threads);
+        char label[64];
+        auto run = [&](const char* name, auto f) {
+            arr = input;
+            double time = measure(f);
+            std::snprintf(label, sizeof(label), "%s, %u threads", name, threads);
+            report(label, n, time);
+        };
+        run("sort", [&] { par.sort(arr); });
+        run("stable_sort", [&] { par.stable_sort(arr); });
+        run("for_each", [&] { par.for_each(arr.begin(), arr.end(), [](int& x) { x = x / 2 + 1; }); });
+        run("transform", [&] { par.transform(arr.begin(), arr.end(), wide.begin(), [](int x) { return 2LL * x; }); });
+        run("reduce", [&] { keep(par.reduce(arr.begin(), arr.end(), 0LL)); });
+        run("inclusive_scan", [&] { par.inclusive_scan(arr.begin(), arr.end(), wide.begin(), Plus<long long>()); });
+        if (threads == cores) break;
+    }
+}
@@ -0,0 +1,35 @@
+// g++ -std=c++20 -O2 -I. bench/pool_allocator.cpp -o pool_allocator && ./pool_allocator [n]
+//
+// Inserts n random ints into a Set, then erases them in another random order, with the
+// default Allocator and with PoolAllocator.
+
+#include "bench/bench.hpp"
+#include "set.hpp"
+#include <vector>
+
+template <TAllocator AlType>
+void run(const char* name, const std::vector<int>& keys, const std::vector<int>& order) {
+    Set<int, Less<int>, AlType> set;
+    double ins = measure([&] {
+        for (int key : keys) set.insert(key);
+    });
+    double ers = measure([&] {
+        for (int key : order) set.erase(key);
+    });
+    char label[64];
+    std::snprintf(label, sizeof(label), "%s insert", name);
+    report(label, keys.size(), ins);
+    std::snprintf(label, sizeof(label), "%s erase", name);
+    report(label, order.size(), ers);
+}
+
+int main(int argc, char** argv) {
+    size_t n = bench_size(argc, argv, 1000000);
+    BenchRandom rnd;
+    std::vector<int> keys(n), order(n);
+    for (size_t i = 0; i < n; ++i) keys[i] = order[i] = int(i);
+    for (size_t i = n; i > 1; --i) std::swap(keys[i - 1], keys[rnd() % i]);
+    for (size_t i = n; i > 1; --i) std::swap(order[i - 1], order[rnd() % i]);
+    run<Allocator<int>>("Allocator", keys, order);
+    run<PoolAllocator<int>>("PoolAllocator", keys, order);
+}
@@ -0,0 +1,60 @@
+// g++ -std=c++20 -O2 -I. bench/radix.cpp -o radix && ./radix [n]
+//
+// Sorts n random keys with Array::radix_sort (LSD), Array::radix_sort_in_place (MSD),
+// std::sort and std::stable_sort, for uint32_t, int64_t and float keys and for 16-byte
+// records sorted by an integer field.
+
+#include "bench/bench.hpp"
+#include "array.hpp"
+#include <algorithm>
+#include <vector>
+
+struct Record {
+    uint32_t id;
+    int64_t value;
+};
+
+struct RecordId {
+    uint32_t operator()(const Record& rec) const noexcept {
+        return rec.id;
+    }
+};
+
+template <typename T, typename KeyFn, typename Comp>
+void run(const char* type, const std::vector<T>& input, KeyFn key, Comp less) {
+    size_t n = input.size();
+    Array<T> arr(n);
+    char label[64];
+    auto sort = [&](const char* name, auto f) {
+        for (size_t i = 0; i < n; ++i) arr[i] = input[i];
+        T* data = &*arr.begin();
+        double time = measure([&] { f(data); });
+        if (!std::is_sorted(data, data + n, less)) std::printf("%s %s: not sorted\n", type, name);
+        std::snprintf(label, sizeof(label), "%s %s", type, name);
+        report(label, n, time);
+    };
+    sort("radix_sort", [&](T*) { arr.radix_sort(key); });
+    sort("radix_sort_in_place", [&](T*) { arr.radix_sort_in_place(key); });
+    sort("std::sort", [&](T* data) { std::sort(data, data + n, less); });
+    sort("std::stable_sort", [&](T* data) { std::stable_sort(data, data + n, less); });
+}
+
+int main(int argc, char** argv) {
+    size_t n = bench_size(argc, argv, 10000000);
+    BenchRandom rnd;
+    std::vector<uint32_t> u32(n);
+    std::vector<int64_t> i64(n);
+    std::vector<float> f32(n);
+    std::vector<Record> rec(n);
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t r = rnd();
+        u32[i] = uint32_t(r);
+        i64[i] = int64_t(r);
+        f32[i] = float(int32_t(r)) / 1024.0f;
+        rec[i] = {uint32_t(r >> 32), int64_t(i)};
+    }
+    run("uint32_t", u32, RadixIdentity(), std::less<uint32_t>());
+    run("int64_t", i64, RadixIdentity(), std::less<int64_t>());
+    run("float", f32, RadixIdentity(), std::less<float>());
+    run("Record", rec, RecordId(), [](const Record& a, const Record& b) { return a.id < b.id; });
+}
@@ -0,0 +1,92 @@
+// g++ -std=c++20 -O2 -I. bench/simd.cpp -o simd && ./simd [n]
+// g++ -std=c++20 -O2 -mavx2 -I. bench/simd.cpp -o simd_avx2 && ./simd_avx2 [n]
+//
+// Runs every SimdKernels operation over n ints and n floats next to the plain loop it
+// replaces. The plain loops are compiled with tree vectorization off, so they stay
+// scalar whatever the optimization level; find and equal scan the whole range.
+
+#include "bench/bench.hpp"
+#include "simd.hpp"
+#include <vector>
+
+#define SCALAR [[gnu::noinline, gnu::optimize("no-tree-vectorize")]]
+
+template <typename T>
+struct Scalar {
+    SCALAR static size_t find(const T* data, size_t n, T val) {
+        for (size_t i = 0; i < n; ++i) if (data[i] == val) return i;
+        return n;
+    }
+
+    SCALAR static size_t count(const T* data, size_t n, T val) {
+        size_t cnt = 0;
+        for (size_t i = 0; i < n; ++i) cnt += (data[i] == val);
+        return cnt;
+    }
+
+    SCALAR static bool equal(const T* a, const T* b, size_t n) {
+        for (size_t i = 0; i < n; ++i) if (a[i] != b[i]) return false;
+        return true;
+    }
+
+    SCALAR static void fill(T* data, size_t n, T val) {
+        for (size_t i = 0; i < n; ++i) data[i] = val;
+    }
+
+    SCALAR static T min(const T* data, size_t n) {
+        T res = data[0];
+        for (size_t i = 1; i < n; ++i) if (data[i] < res) res = data[i];
+        return res;
+    }
+
+    SCALAR static T max(const T* data, size_t n) {
+        T res = data[0];
+        for (size_t i = 1; i < n; ++i) if (res < data[i]) res = data[i];
+        return res;
+    }
+
+    SCALAR static T sum(const T* data, size_t n) {
+        T res = T();
+        for (size_t i = 0; i < n; ++i) res += data[i];
+        return res;
+    }
+};
+
+template <typename T>
+void run(const char* type, size_t n, int rounds) {
+    using Kernels = SimdKernels<T>;
+    std::vector<T> a(n), b(n);
+    BenchRandom rnd;
+    for (size_t i = 0; i < n; ++i) a[i] = b[i] = T(rnd() % 1000);
+    const T absent = T(-1);
+    char label[64];
+    auto compare = [&](const char* op, auto scalar, auto simd) {
+        double s = measure([&] { for (int r = 0; r < rounds; ++r) keep(scalar()); });
+        double v = measure([&] { for (int r = 0; r < rounds; ++r) keep(simd()); });
+        std::snprintf(label, sizeof(label), "%s %s scalar", type, op);
+        report(label, rounds * n, s);
+        std::snprintf(label, sizeof(label), "%s %s simd", type, op);
+        report(label, rounds * n, v);
+    };
+    compare("find", [&] { return Scalar<T>::find(a.data(), n, absent); },
+                    [&] { return Kernels::find(a.data(), n, absent); });
+    compare("count", [&] { return Scalar<T>::count(a.data(), n, T(7)); },
+                     [&] { return Kernels::count(a.data(), n, T(7)); });
+    compare("equal", [&] { return Scalar<T>::equal(a.data(), b.data(), n); },
+                     [&] { return Kernels::equal(a.data(), b.data(), n); });
+    compare("min", [&] { return Scalar<T>::min(a.data(), n); },
+                   [&] { return Kernels::min(a.data(), n); });
+    compare("max", [&] { return Scalar<T>::max(a.data(), n); },
+                   [&] { return Kernels::max(a.data(), n); });
+    compare("sum", [&] { return Scalar<T>::sum(a.data(), n); },
+                   [&] { return Kernels::sum(a.data(), n); });
+    compare("fill", [&] { Scalar<T>::fill(b.data(), n, T(3)); return b[n / 2]; },
+                    [&] { Kernels::fill(b.data(), n, T(3)); return b[n / 2]; });
+}
+
+int main(int argc, char** argv) {
+    size_t n = bench_size(argc, argv, 1 << 20);
+    std::printf("vector width %zu bytes\n", simd_width);
+    run<int>("int", n, 100);
+    run<float>("float", n, 100);
+}
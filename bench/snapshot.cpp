@@ -0,0 +1,53 @@
+// g++ -std=c++20 -O2 -I. bench/snapshot.cpp -o snapshot && ./snapshot [n]
+//
+// Saves containers of n elements to a memory stream and loads them back: an Array<int>
+// (one bulk write and read), an Array<Array<int>> of short rows, a List<int> and a
+// Set<int> (reloaded with the O(n) bulk build). Reports MB/s of snapshot data each way;
+// for the Set, also the time to build it by inserting the same values one by one.
+
+#include "bench/bench.hpp"
+#include "list.hpp"
+#include "set.hpp"
+#include <sstream>
+
+template <typename Container>
+void run(const char* name, const Container& src, size_t n) {
+    std::stringstream stream;
+    double save = measure([&] { src.save(stream); });
+    size_t bytes = stream.str().size();
+    Container dst;
+    double load = measure([&] { dst.load(stream); });
+    char label[64];
+    std::snprintf(label, sizeof(label), "%s save", name);
+    report(label, n, save);
+    std::printf("%40s %12.1f MB/s\n", "", bytes / save / 1e6);
+    std::snprintf(label, sizeof(label), "%s load", name);
+    report(label, n, load);
+    std::printf("%40s %12.1f MB/s\n", "", bytes / load / 1e6);
+}
+
+int main(int argc, char** argv) {
+    size_t n = bench_size(argc, argv, 1000000);
+    BenchRandom rnd;
+
+    Array<int> arr(n);
+    for (size_t i = 0; i < n; ++i) arr[i] = int(rnd());
+    run("Array<int>", arr, n);
+
+    Array<Array<int>> rows(n / 16);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        for (int k = 0; k < 16; ++k) rows[i].append(int(rnd()));
+    }
+    run("Array<Array<int>>", rows, n);
+
+    List<int> list;
+    for (size_t i = 0; i < n; ++i) list.append(int(rnd()));
+    run("List<int>", list, n);
+
+    Set<int> set;
+    double build = measure([&] {
+        for (size_t i = 0; i < n; ++i) set.insert(int(i));
+    });
+    run("Set<int>", set, n);
+    report("Set<int> insert one by one", n, build);
+}
@@ -0,0 +1,67 @@
+// g++ -std=c++20 -O2 -I. bench/soaarray.cpp -o soaarray && ./soaarray [n]
+//
+// Scans n particles of eight fields (40 bytes each) stored as an Array of structs and as
+// a SoAArray: summing one field, and updating one field from another. The struct layout
+// drags every field through the cache; the columns read only the ones used.
+
+#include "bench/bench.hpp"
+#include "soaarray.hpp"
+
+struct Particle {
+    float x, y, z;
+    float vx, vy, vz;
+    int id;
+    double mass;
+};
+
+int main(int argc, char** argv) {
+    size_t n = bench_size(argc, argv, 10000000);
+    const int rounds = 10;
+    Array<Particle, AlignedAllocator<Particle>> aos(n);
+    SoAArray<float, float, float, float, float, float, int, double> soa;
+    soa.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        float f = float(i % 1000);
+        aos[i] = {f, f, f, 1.0f, 1.0f, 1.0f, int(i), 1.0};
+        soa.emplace_back(f, f, f, 1.0f, 1.0f, 1.0f, int(i), 1.0);
+    }
+    Particle* particles = &*aos.begin();
+    float* x = &*soa.begin<0>();
+    float* vx = &*soa.begin<3>();
+    float sum = 0;
+
+    double aos_sum = measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < n; ++i) sum += particles[i].x;
+        }
+    });
+    keep(sum);
+    double soa_sum = measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < n; ++i) sum += x[i];
+        }
+    });
+    keep(sum);
+    double soa_column_sum = measure([&] {
+        for (int r = 0; r < rounds; ++r) sum += soa.column<0>().sum();
+    });
+    keep(sum);
+    double aos_update = measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < n; ++i) particles[i].x += particles[i].vx;
+        }
+    });
+    keep(particles[n / 2]);
+    double soa_update = measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < n; ++i) x[i] += vx[i];
+        }
+    });
+    keep(x[n / 2]);
+
+    report("AoS sum of x", rounds * n, aos_sum);
+    report("SoA sum of x", rounds * n, soa_sum);
+    report("SoA column<0>().sum()", rounds * n, soa_column_sum);
+    report("AoS x += vx", rounds * n, aos_update);
+    report("SoA x += vx", rounds * n, soa_update);
+}
@@ -0,0 +1,44 @@
+// g++ -std=c++20 -O2 -I. bench/thread_caching_allocator.cpp -pthread -o thread_caching_allocator && ./thread_caching_allocator [n]
+//
+// Every thread inserts n random ints into a Set of its own and erases them again, with
+// the default Allocator and with ThreadCachingAllocator, for 1 up to as many threads as
+// there are cores. Reports the total throughput; with the malloc-backed Allocator the
+// threads contend for the heap, with ThreadCachingAllocator they shouldn't.
+
+#include "bench/bench.hpp"
+#include "set.hpp"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+template <TAllocator AlType>
+void work(size_t n, uint64_t seed) {
+    BenchRandom rnd{seed};
+    std::vector<int> keys(n);
+    for (size_t i = 0; i < n; ++i) keys[i] = int(rnd() >> 33);
+    Set<int, Less<int>, AlType> set;
+    for (int key : keys) set.insert(key);
+    for (int key : keys) set.erase(key);
+}
+
+template <TAllocator AlType>
+void run(const char* name, size_t n, unsigned threads) {
+    double time = measure([&] {
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; ++t) pool.emplace_back(work<AlType>, n, 0x9E3779B97F4A7C15ull + t);
+        for (auto& thread : pool) thread.join();
+    });
+    char label[64];
+    std::snprintf(label, sizeof(label), "%s, %u threads", name, threads);
+    report(label, 2 * n * threads, time);
+}
+
+int main(int argc, char** argv) {
+    size_t n = bench_size(argc, argv, 200000);
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1;; threads = std::min(2 * threads, cores)) {
+        run<Allocator<int>>("Allocator", n, threads);
+        run<ThreadCachingAllocator<int>>("ThreadCachingAllocator", n, threads);
+        if (threads == cores) break;
+    }
+}
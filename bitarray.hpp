@@ -0,0 +1,615 @@
+#pragma once
+
+#include "array.hpp"
+#include <bit>
+#include <cstdint>
+#include <initializer_list>
+
+// Reference to one bit of a BitArray; writes through it mark the rank index stale.
+class BitReference {
+public:
+    using Word = uint64_t;
+
+    operator bool() const noexcept {
+        return *word & mask;
+    }
+
+    BitReference& operator=(bool val) noexcept {
+        if (val) *word |= mask;
+        else *word &= ~mask;
+        *stale = true;
+        return *this;
+    }
+
+    BitReference& operator=(const BitReference& other) noexcept {
+        return *this = bool(other);
+    }
+
+    void flip() noexcept {
+        *word ^= mask;
+        *stale = true;
+    }
+
+private:
+    template <TAllocator AlType, GrowthPolicy GrType>
+    friend class BitArray;
+    friend class bitIterator;
+
+    BitReference(Word* word, Word mask, bool* stale) noexcept : word(word), mask(mask), stale(stale) {}
+
+    Word* word;
+    Word mask;
+    bool* stale;
+};
+
+class bitIterator : public RandomAccessIterator<bool> {
+public:
+    using Base              = RandomAccessIterator<bool>;
+    using Word              = uint64_t;
+    using ItDiff            = typename Base::ItDiff;
+    using SizeType          = typename Base::SizeType;
+
+    template <TAllocator AllocatorType, GrowthPolicy GrType>
+    friend class BitArray;
+
+private:
+    bitIterator(Word* const& words, const SizeType& size, bool& stale, SizeType pos) : words(words), size(size), stale(stale), pos(pos) {}
+
+public:
+
+    bool operator==(const bitIterator& it) const noexcept {
+        if constexpr (checked_access) {
+            return &size == &it.size && pos == it.pos;
+        } else {
+            return pos == it.pos;
+        }
+    }
+
+    bool operator!=(const bitIterator& it) const noexcept {
+        return !(*this == it);
+    }
+
+    bool operator>(const bitIterator& it) const {
+        Check(it);
+        return pos > it.pos;
+    }
+
+    bool operator<(const bitIterator& it) const {
+        Check(it);
+        return pos < it.pos;
+    }
+
+    bool operator>=(const bitIterator& it) const {
+        Check(it);
+        return pos >= it.pos;
+    }
+
+    bool operator<=(const bitIterator& it) const {
+        Check(it);
+        return pos <= it.pos;
+    }
+
+    BitReference operator*() const {
+        if constexpr (checked_access) {
+            if (pos >= size) throw UndereferencableIterator();
+        }
+        return BitReference(words + pos / 64, Word(1) << (pos % 64), &stale);
+    }
+
+    bitIterator& operator++() {
+        if constexpr (checked_access) {
+            if (pos >= size) throw IteratorOutOfBounds();
+        }
+        ++pos;
+        return *this;
+    }
+
+    bitIterator operator++(int) {
+        bitIterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    bitIterator& operator--() {
+        if constexpr (checked_access) {
+            if (pos == 0) throw IteratorOutOfBounds();
+        }
+        --pos;
+        return *this;
+    }
+
+    bitIterator operator--(int) {
+        bitIterator it = *this;
+        --*this;
+        return it;
+    }
+
+    bitIterator& operator+=(ItDiff offset) {
+        if constexpr (checked_access) {
+            if (pos + offset > size) throw IteratorOutOfBounds();
+        }
+        pos += offset;
+        return *this;
+    }
+
+    bitIterator& operator-=(ItDiff offset) {
+        return *this += -offset;
+    }
+
+    bitIterator operator+ (ItDiff offset) const {
+        bitIterator it = *this;
+        return it += offset;
+    }
+
+    bitIterator operator- (ItDiff offset) const {
+        bitIterator it = *this;
+        return it += -offset;
+    }
+
+    ItDiff operator- (const bitIterator& it) const {
+        Check(it);
+        return ItDiff(pos) - it.pos;
+    }
+
+private:
+    void Check(const bitIterator& it) const {
+        if constexpr (checked_access) {
+            if (&size != &it.size) throw NotComparableIterators();
+        }
+    }
+
+    Word* const& words;
+    const SizeType& size;
+    bool& stale;
+    SizeType pos;
+};
+
+class constBitIterator : public ConstRandomAccessIterator<bool> {
+public:
+    using Base              = ConstRandomAccessIterator<bool>;
+    using Word              = uint64_t;
+    using ItDiff            = typename Base::ItDiff;
+    using SizeType          = typename Base::SizeType;
+
+    template <TAllocator AllocatorType, GrowthPolicy GrType>
+    friend class BitArray;
+
+private:
+    constBitIterator(Word* const& words, const SizeType& size, SizeType pos) : words(words), size(size), pos(pos) {}
+
+public:
+
+    bool operator==(const constBitIterator& it) const noexcept {
+        if constexpr (checked_access) {
+            return &size == &it.size && pos == it.pos;
+        } else {
+            return pos == it.pos;
+        }
+    }
+
+    bool operator!=(const constBitIterator& it) const noexcept {
+        return !(*this == it);
+    }
+
+    bool operator>(const constBitIterator& it) const {
+        Check(it);
+        return pos > it.pos;
+    }
+
+    bool operator<(const constBitIterator& it) const {
+        Check(it);
+        return pos < it.pos;
+    }
+
+    bool operator>=(const constBitIterator& it) const {
+        Check(it);
+        return pos >= it.pos;
+    }
+
+    bool operator<=(const constBitIterator& it) const {
+        Check(it);
+        return pos <= it.pos;
+    }
+
+    bool operator*() const {
+        if constexpr (checked_access) {
+            if (pos >= size) throw UndereferencableIterator();
+        }
+        return words[pos / 64] >> (pos % 64) & 1;
+    }
+
+    constBitIterator& operator++() {
+        if constexpr (checked_access) {
+            if (pos >= size) throw IteratorOutOfBounds();
+        }
+        ++pos;
+        return *this;
+    }
+
+    constBitIterator operator++(int) {
+        constBitIterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    constBitIterator& operator--() {
+        if constexpr (checked_access) {
+            if (pos == 0) throw IteratorOutOfBounds();
+        }
+        --pos;
+        return *this;
+    }
+
+    constBitIterator operator--(int) {
+        constBitIterator it = *this;
+        --*this;
+        return it;
+    }
+
+    constBitIterator& operator+=(ItDiff offset) {
+        if constexpr (checked_access) {
+            if (pos + offset > size) throw IteratorOutOfBounds();
+        }
+        pos += offset;
+        return *this;
+    }
+
+    constBitIterator& operator-=(ItDiff offset) {
+        return *this += -offset;
+    }
+
+    constBitIterator operator+ (ItDiff offset) const {
+        constBitIterator it = *this;
+        return it += offset;
+    }
+
+    constBitIterator operator- (ItDiff offset) const {
+        constBitIterator it = *this;
+        return it += -offset;
+    }
+
+    ItDiff operator- (const constBitIterator& it) const {
+        Check(it);
+        return ItDiff(pos) - it.pos;
+    }
+
+private:
+    void Check(const constBitIterator& it) const {
+        if constexpr (checked_access) {
+            if (&size != &it.size) throw NotComparableIterators();
+        }
+    }
+
+    Word* const& words;
+    const SizeType& size;
+    SizeType pos;
+};
+
+// Array of bits packed 64 to a word. Whole-array and range set/reset/flip, count and
+// find_first/find_next work a word at a time. rank(i) (ones before i) is O(1) and
+// select(k) (position of the k-th one) O(log n) through an index of one count per 512
+// bits, rebuilt on the first query after a change. Bits past size() are always zero.
+template <TAllocator AlType = Allocator<uint64_t>, GrowthPolicy GrType = DoubleGrowth>
+class BitArray {
+
+public:
+    using ValueType             = bool;
+    using Word                  = uint64_t;
+    using Reference             = BitReference;
+    using ConstReference        = bool;
+    using AllocatorType         = AlType;
+    using GrowthType            = GrType;
+    using Iterator              = bitIterator;
+    using ConstIterator         = constBitIterator;
+    using SizeType              = typename Iterator::SizeType;
+    using ItDiff                = typename Iterator::ItDiff;
+
+    static constexpr SizeType word_bits = 64;
+    static constexpr SizeType block_words = 8;
+
+private:
+    using AllocTraits       = AllocatorTraits<Word, AllocatorType>;
+
+public:
+
+    BitArray() : words(nullptr), _size(0), cap(0), stale(true), alloc() {}
+
+    BitArray(SizeType n, bool val = false) : BitArray() {
+        Resize(n);
+        if (val) set();
+    }
+
+    BitArray(const std::initializer_list<bool>& list) : BitArray(list.size()) {
+        SizeType i = 0;
+        for (auto it = list.begin(); it != list.end(); ++it, ++i) {
+            if (*it) words[i / word_bits] |= Word(1) << (i % word_bits);
+        }
+    }
+
+    BitArray(const BitArray& other) : BitArray() {
+        Resize(other._size);
+        std::copy(other.words, other.words + Words(_size), words);
+    }
+
+    BitArray(BitArray&& other) : BitArray() {
+        Swap(other);
+    }
+
+    ~BitArray() {
+        AllocTraits::deallocate(alloc, words, Words(cap));
+    }
+
+    void operator=(const BitArray& other) {
+        if (this == &other) return;
+        BitArray copy(other);
+        Swap(copy);
+    }
+
+    void operator=(BitArray&& other) {
+        BitArray moved(std::move(other));
+        Swap(moved);
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(words, _size, stale, 0);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return ConstIterator(words, _size, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(words, _size, stale, _size);
+    }
+
+    ConstIterator cend() const noexcept {
+        return ConstIterator(words, _size, _size);
+    }
+
+    SizeType size() const noexcept {
+        return _size;
+    }
+
+    SizeType capacity() const noexcept {
+        return cap;
+    }
+
+    bool operator==(const BitArray& other) const noexcept {
+        return _size == other._size && std::equal(words, words + Words(_size), other.words);
+    }
+
+    bool operator!=(const BitArray& other) const noexcept {
+        return !(*this == other);
+    }
+
+    void reserve(SizeType n) {
+        if (n <= cap) return;
+        n = Words(n) * word_bits;
+        words = AllocTraits::reallocate(alloc, words, Words(cap), Words(n), Words(_size));
+        cap = n;
+    }
+
+    void append(bool val) {
+        if (_size == cap) reserve(GrowthType::next(cap, _size + 1));
+        if (_size % word_bits == 0) words[_size / word_bits] = 0;
+        if (val) words[_size / word_bits] |= Word(1) << (_size % word_bits);
+        ++_size;
+        stale = true;
+    }
+
+    void pop() {
+        if (_size == 0) throw NothingToErase();
+        --_size;
+        words[_size / word_bits] &= ~(Word(1) << (_size % word_bits));
+        stale = true;
+    }
+
+    bool test(SizeType ind) const noexcept {
+        return words[ind / word_bits] >> (ind % word_bits) & 1;
+    }
+
+    // index taken modulo size, negative indices count from the end
+    Reference at(ItDiff ind) noexcept {
+        SizeType i = (ind >= 0 ? ind % _size : (_size + ind % ItDiff(_size)) % _size);
+        return Reference(words + i / word_bits, Word(1) << (i % word_bits), &stale);
+    }
+
+    // wraps like at() in checked mode, plain offset in unchecked mode
+    Reference operator[](ItDiff ind) noexcept {
+        if constexpr (checked_access) {
+            return at(ind);
+        } else {
+            return Reference(words + ind / word_bits, Word(1) << (ind % word_bits), &stale);
+        }
+    }
+
+    ConstReference operator[](ItDiff ind) const noexcept {
+        return bool(const_cast<BitArray&>(*this)[ind]);
+    }
+
+    void set(SizeType ind, bool val = true) noexcept {
+        (*this)[ind] = val;
+    }
+
+    void reset(SizeType ind) noexcept {
+        (*this)[ind] = false;
+    }
+
+    void flip(SizeType ind) noexcept {
+        (*this)[ind].flip();
+    }
+
+    void set() noexcept {
+        set_range(0, _size, true);
+    }
+
+    void reset() noexcept {
+        set_range(0, _size, false);
+    }
+
+    void flip() noexcept {
+        flip_range(0, _size);
+    }
+
+    // bits [from, to)
+    void set_range(SizeType from, SizeType to, bool val = true) noexcept {
+        ForRange(from, to, [val](Word& word, Word mask) {
+            if (val) word |= mask;
+            else word &= ~mask;
+        });
+    }
+
+    void reset_range(SizeType from, SizeType to) noexcept {
+        set_range(from, to, false);
+    }
+
+    void flip_range(SizeType from, SizeType to) noexcept {
+        ForRange(from, to, [](Word& word, Word mask) {
+            word ^= mask;
+        });
+    }
+
+    // bits [from, to) as a new BitArray, to clamped to the size; a view would have to
+    // shift every word it reads unless from is word-aligned, so this copies, a word at a time
+    BitArray slice(SizeType from, SizeType to) const {
+        if (to > _size) to = _size;
+        BitArray res;
+        if (from >= to) return res;
+        res.Resize(to - from);
+        SizeType first = from / word_bits, shift = from % word_bits, n = Words(to - from), total = Words(_size);
+        for (SizeType i = 0; i < n; ++i) {
+            Word word = words[first + i] >> shift;
+            if (shift && first + i + 1 < total) word |= words[first + i + 1] << (word_bits - shift);
+            res.words[i] = word;
+        }
+        if ((to - from) % word_bits) res.words[n - 1] &= (Word(1) << ((to - from) % word_bits)) - 1;
+        return res;
+    }
+
+    SizeType count() const noexcept {
+        SizeType res = 0;
+        for (SizeType i = 0, n = Words(_size); i < n; ++i) res += std::popcount(words[i]);
+        return res;
+    }
+
+    bool any() const noexcept {
+        return find_first() != _size;
+    }
+
+    bool none() const noexcept {
+        return !any();
+    }
+
+    bool all() const noexcept {
+        return count() == _size;
+    }
+
+    // position of the first set bit, size() if there is none
+    SizeType find_first() const noexcept {
+        return FindFrom(0);
+    }
+
+    // position of the first set bit after pos, size() if there is none
+    SizeType find_next(SizeType pos) const noexcept {
+        return (pos + 1 >= _size ? _size : FindFrom(pos + 1));
+    }
+
+    // number of set bits in [0, ind)
+    SizeType rank(SizeType ind) const {
+        if (ind > _size) throw IteratorOutOfBounds();
+        BuildRank();
+        SizeType w = ind / word_bits, block = w / block_words;
+        SizeType res = blocks[block];
+        for (SizeType i = block*block_words; i < w; ++i) res += std::popcount(words[i]);
+        if (ind % word_bits) res += std::popcount(words[w] & ((Word(1) << (ind % word_bits)) - 1));
+        return res;
+    }
+
+    // position of the set bit with rank k (the (k+1)-th one), size() if there are fewer
+    SizeType select(SizeType k) const {
+        BuildRank();
+        if (k >= blocks[blocks.size() - 1]) return _size;
+        // the last block whose count before it is at most k
+        SizeType lo = 0, hi = blocks.size() - 1;
+        while (hi - lo > 1) {
+            SizeType mid = (lo + hi) / 2;
+            if (blocks[mid] <= k) lo = mid;
+            else hi = mid;
+        }
+        k -= blocks[lo];
+        SizeType w = lo*block_words;
+        for (SizeType ones = std::popcount(words[w]); ones <= k; ones = std::popcount(words[++w])) k -= ones;
+        Word word = words[w];
+        for (; k > 0; --k) word &= word - 1;
+        return w*word_bits + std::countr_zero(word);
+    }
+
+private:
+    static SizeType Words(SizeType bits) noexcept {
+        return (bits + word_bits - 1) / word_bits;
+    }
+
+    void Resize(SizeType n) {
+        reserve(n);
+        std::fill(words, words + Words(n), Word(0));
+        _size = n;
+        stale = true;
+    }
+
+    template <typename F>
+    void ForRange(SizeType from, SizeType to, F f) noexcept {
+        if (to > _size) to = _size;
+        if (from >= to) return;
+        stale = true;
+        SizeType first = from / word_bits, last = (to - 1) / word_bits;
+        Word head = ~Word(0) << (from % word_bits);
+        Word tail = ~Word(0) >> (word_bits - 1 - (to - 1) % word_bits);
+        if (first == last) {
+            f(words[first], head & tail);
+            return;
+        }
+        f(words[first], head);
+        for (SizeType i = first + 1; i < last; ++i) f(words[i], ~Word(0));
+        f(words[last], tail);
+    }
+
+    SizeType FindFrom(SizeType pos) const noexcept {
+        SizeType n = Words(_size), w = pos / word_bits;
+        if (w >= n) return _size;
+        Word word = words[w] & (~Word(0) << (pos % word_bits));
+        while (word == 0) {
+            if (++w == n) return _size;
+            word = words[w];
+        }
+        return w*word_bits + std::countr_zero(word);
+    }
+
+    // blocks[b] is the number of set bits before block b, with one extra entry for the total
+    void BuildRank() const {
+        if (!stale) return;
+        SizeType n = Words(_size), count = (n + block_words - 1) / block_words;
+        blocks = Array<SizeType>(count + 1);
+        SizeType total = 0;
+        for (SizeType b = 0; b < count; ++b) {
+            blocks[b] = total;
+            for (SizeType i = b*block_words; i < n && i < (b + 1)*block_words; ++i) total += std::popcount(words[i]);
+        }
+        blocks[count] = total;
+        stale = false;
+    }
+
+    void Swap(BitArray& other) {
+        std::swap(words, other.words);
+        std::swap(_size, other._size);
+        std::swap(cap, other.cap);
+        std::swap(stale, other.stale);
+        std::swap(alloc, other.alloc);
+        std::swap(blocks, other.blocks);
+    }
+
+    Word* words;
+    SizeType _size, cap;
+    mutable bool stale;
+    AllocatorType alloc;
+    mutable Array<SizeType> blocks;
+};
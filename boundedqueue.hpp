@@ -0,0 +1,290 @@
+#pragma once
+
+#include "allocator.hpp"
+#include "altraits.hpp"
+#include "exceptions.hpp"
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <thread>
+
+// indices written by different threads are kept this far apart, so they don't share a cache line
+inline constexpr size_t cache_line = 64;
+
+// Bounded queue for one producer thread and one consumer thread. Both ends are wait-free:
+// the producer owns tail and the consumer owns head, each on its own cache line, and each
+// side keeps a private copy of the other's index so that it only reloads the shared one
+// when the queue looks full (or empty). Capacity is rounded up to a power of two.
+template <std::default_initializable VType, TAllocator AlType = Allocator<VType>>
+class SPSCQueue {
+
+public:
+    using ValueType             = VType;
+    using Pointer               = ValueType*;
+    using ConstPointer          = const ValueType*;
+    using AllocatorType         = AlType;
+    using SizeType              = size_t;
+
+private:
+    using AllocTraits       = AllocatorTraits<ValueType, AllocatorType>;
+
+public:
+
+    explicit SPSCQueue(SizeType capacity) : mask(std::bit_ceil(capacity) - 1), alloc() {
+        slots = AllocTraits::allocate(alloc, mask + 1);
+    }
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    // must not race with anything
+    ~SPSCQueue() {
+        SizeType t = tail.load(std::memory_order_relaxed);
+        for (SizeType h = head.load(std::memory_order_relaxed); h != t; ++h) {
+            AllocTraits::destroy(alloc, slots + (h & mask));
+        }
+        AllocTraits::deallocate(alloc, slots, mask + 1);
+    }
+
+    SizeType capacity() const noexcept {
+        return mask + 1;
+    }
+
+    // a snapshot, exact only when neither side is running
+    SizeType size() const noexcept {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    // producer side; false if the queue is full
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        SizeType t = tail.load(std::memory_order_relaxed);
+        if (t - head_cache == mask + 1) {
+            head_cache = head.load(std::memory_order_acquire);
+            if (t - head_cache == mask + 1) return false;
+        }
+        AllocTraits::construct(alloc, slots + (t & mask), std::forward<Args>(args)...);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const ValueType& val) {
+        return try_emplace(val);
+    }
+
+    bool try_push(ValueType&& val) {
+        return try_emplace(std::move(val));
+    }
+
+    // producer side; copies as many of the n elements as fit, the number copied
+    SizeType try_push(ConstPointer data, SizeType n) {
+        SizeType t = tail.load(std::memory_order_relaxed);
+        if (mask + 1 - (t - head_cache) < n) head_cache = head.load(std::memory_order_acquire);
+        SizeType k = std::min(n, mask + 1 - (t - head_cache));
+        for (SizeType i = 0; i < k; ++i) AllocTraits::construct(alloc, slots + ((t + i) & mask), data[i]);
+        tail.store(t + k, std::memory_order_release);
+        return k;
+    }
+
+    // consumer side; false if the queue is empty
+    bool try_pop(ValueType& out) {
+        SizeType h = head.load(std::memory_order_relaxed);
+        if (h == tail_cache) {
+            tail_cache = tail.load(std::memory_order_acquire);
+            if (h == tail_cache) return false;
+        }
+        Pointer slot = slots + (h & mask);
+        out = std::move(*slot);
+        AllocTraits::destroy(alloc, slot);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side; moves up to n elements into out, the number moved
+    SizeType try_pop(Pointer out, SizeType n) {
+        SizeType h = head.load(std::memory_order_relaxed);
+        if (tail_cache - h < n) tail_cache = tail.load(std::memory_order_acquire);
+        SizeType k = std::min(n, tail_cache - h);
+        for (SizeType i = 0; i < k; ++i) {
+            Pointer slot = slots + ((h + i) & mask);
+            out[i] = std::move(*slot);
+            AllocTraits::destroy(alloc, slot);
+        }
+        head.store(h + k, std::memory_order_release);
+        return k;
+    }
+
+    // blocking versions, yielding while the queue is full (or empty)
+    void push(const ValueType& val) {
+        while (!try_push(val)) std::this_thread::yield();
+    }
+
+    void pop(ValueType& out) {
+        while (!try_pop(out)) std::this_thread::yield();
+    }
+
+private:
+    // written by the consumer
+    alignas(cache_line) std::atomic<SizeType> head = 0;
+    SizeType tail_cache = 0;
+    // written by the producer
+    alignas(cache_line) std::atomic<SizeType> tail = 0;
+    SizeType head_cache = 0;
+    // read-only after construction
+    alignas(cache_line) Pointer slots;
+    SizeType mask;
+    AllocatorType alloc;
+};
+
+// Bounded queue for any number of producers and consumers, lock-free. Every slot carries
+// a sequence number telling whose turn it is: a producer with ticket pos may fill slot
+// pos & mask once its sequence is pos, a consumer may empty it once it is pos + 1, after
+// which it becomes pos + capacity for the producer a lap later. Tickets are taken with a
+// CAS on the (padded) enqueue or dequeue index; a batch takes as many consecutive ready
+// slots as it can with a single CAS.
+template <std::default_initializable VType, TAllocator AlType = Allocator<VType>>
+class MPMCQueue {
+
+public:
+    using ValueType             = VType;
+    using Pointer               = ValueType*;
+    using ConstPointer          = const ValueType*;
+    using AllocatorType         = AlType;
+    using SizeType              = size_t;
+
+private:
+    using AllocTraits       = AllocatorTraits<ValueType, AllocatorType>;
+
+    struct Slot {
+        std::atomic<SizeType> seq;
+        alignas(ValueType) unsigned char storage[sizeof(ValueType)];
+
+        Slot(SizeType seq) : seq(seq) {}
+
+        Pointer value() noexcept {
+            return reinterpret_cast<Pointer>(storage);
+        }
+    };
+
+    using SlotAlloc         = typename AllocatorType::RebindAlloc<Slot>;
+    using SlotAllocTraits   = AllocatorTraits<Slot, SlotAlloc>;
+
+public:
+
+    explicit MPMCQueue(SizeType capacity) : mask(std::bit_ceil(capacity) - 1), alloc(), slot_alloc() {
+        slots = SlotAllocTraits::allocate(slot_alloc, mask + 1);
+        for (SizeType i = 0; i <= mask; ++i) SlotAllocTraits::construct(slot_alloc, slots + i, i);
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    // must not race with anything
+    ~MPMCQueue() {
+        SizeType t = enqueue_pos.load(std::memory_order_relaxed);
+        for (SizeType h = dequeue_pos.load(std::memory_order_relaxed); h != t; ++h) {
+            AllocTraits::destroy(alloc, slots[h & mask].value());
+        }
+        for (SizeType i = 0; i <= mask; ++i) SlotAllocTraits::destroy(slot_alloc, slots + i);
+        SlotAllocTraits::deallocate(slot_alloc, slots, mask + 1);
+    }
+
+    SizeType capacity() const noexcept {
+        return mask + 1;
+    }
+
+    // a snapshot, exact only when nobody is pushing or popping
+    SizeType size() const noexcept {
+        SizeType h = dequeue_pos.load(std::memory_order_acquire);
+        SizeType t = enqueue_pos.load(std::memory_order_acquire);
+        return (t > h ? t - h : 0);
+    }
+
+    // false if the queue is full
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        SizeType pos;
+        if (Claim(enqueue_pos, 0, 1, pos) == 0) return false;
+        Slot& slot = slots[pos & mask];
+        AllocTraits::construct(alloc, slot.value(), std::forward<Args>(args)...);
+        slot.seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const ValueType& val) {
+        return try_emplace(val);
+    }
+
+    bool try_push(ValueType&& val) {
+        return try_emplace(std::move(val));
+    }
+
+    // copies as many of the n elements as there are free slots in a row, the number copied
+    SizeType try_push(ConstPointer data, SizeType n) {
+        SizeType pos;
+        SizeType k = Claim(enqueue_pos, 0, n, pos);
+        for (SizeType i = 0; i < k; ++i) {
+            Slot& slot = slots[(pos + i) & mask];
+            AllocTraits::construct(alloc, slot.value(), data[i]);
+            slot.seq.store(pos + i + 1, std::memory_order_release);
+        }
+        return k;
+    }
+
+    // false if the queue is empty
+    bool try_pop(ValueType& out) {
+        return try_pop(&out, 1) == 1;
+    }
+
+    // moves up to n elements into out, as many as are ready in a row, the number moved
+    SizeType try_pop(Pointer out, SizeType n) {
+        SizeType pos;
+        SizeType k = Claim(dequeue_pos, 1, n, pos);
+        for (SizeType i = 0; i < k; ++i) {
+            Slot& slot = slots[(pos + i) & mask];
+            out[i] = std::move(*slot.value());
+            AllocTraits::destroy(alloc, slot.value());
+            slot.seq.store(pos + i + mask + 1, std::memory_order_release);
+        }
+        return k;
+    }
+
+    // blocking versions, yielding while the queue is full (or empty)
+    void push(const ValueType& val) {
+        while (!try_push(val)) std::this_thread::yield();
+    }
+
+    void pop(ValueType& out) {
+        while (!try_pop(out)) std::this_thread::yield();
+    }
+
+private:
+    // takes tickets [pos, pos + k) from index, for the longest run of at most n slots whose
+    // sequence is ticket + lag, lag being 0 for producers and 1 for consumers; 0 if none is ready
+    SizeType Claim(std::atomic<SizeType>& index, SizeType lag, SizeType n, SizeType& pos) {
+        pos = index.load(std::memory_order_relaxed);
+        while (n != 0) {
+            SizeType k = 0;
+            for (; k < n && k <= mask; ++k) {
+                SizeType seq = slots[(pos + k) & mask].seq.load(std::memory_order_acquire);
+                if (seq != pos + k + lag) break;
+            }
+            if (k == 0) {
+                // either another thread took pos (its sequence moved ahead), or the slot isn't ready
+                SizeType seq = slots[pos & mask].seq.load(std::memory_order_acquire);
+                if (intptr_t(seq - (pos + lag)) < 0) return 0;
+                pos = index.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (index.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) return k;
+        }
+        return 0;
+    }
+
+    alignas(cache_line) std::atomic<SizeType> enqueue_pos = 0;
+    alignas(cache_line) std::atomic<SizeType> dequeue_pos = 0;
+    alignas(cache_line) Slot* slots;
+    SizeType mask;
+    AllocatorType alloc;
+    SlotAlloc slot_alloc;
+};
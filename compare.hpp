@@ -0,0 +1,22 @@
+#pragma once
+
+#include <concepts>
+
+template <typename T, typename V>
+concept Comparator = requires (T a, V v) {
+    {a(v, v)} -> std::same_as<bool>;
+};
+
+template <typename V>
+struct Less {
+    bool operator()(const V& v1, const V& v2) const noexcept {
+        return v1 < v2;
+    }
+};
+
+template <typename V>
+struct Plus {
+    V operator()(const V& v1, const V& v2) const {
+        return v1 + v2;
+    }
+};
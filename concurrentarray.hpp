@@ -0,0 +1,153 @@
+#pragma once
+
+#include "allocator.hpp"
+#include "altraits.hpp"
+#include "iterators.hpp"
+#include "exceptions.hpp"
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+// Array that many threads append to without locks. append() claims an index with one
+// fetch_add, constructs the element there and marks it published; storage is a fixed
+// table of buckets of doubling size (bucket k holds first_bucket << k elements), so
+// growing never moves an element and a missing bucket is installed with a CAS (a thread
+// losing the race frees its copy). Reading an index is safe once it is published:
+// either published(ind) returned true or the index came from append() through some
+// synchronization. AlType must be usable from several threads, as Allocator is.
+template <std::default_initializable VType, TAllocator AlType = Allocator<VType>>
+class ConcurrentArray {
+
+public:
+    using ValueType             = VType;
+    using Pointer               = ValueType*;
+    using Reference             = ValueType&;
+    using ConstPointer          = const ValueType*;
+    using ConstReference        = const ValueType&;
+    using AllocatorType         = AlType;
+    using SizeType              = size_t;
+
+    static constexpr SizeType first_bucket = 64;
+
+private:
+    using Word              = std::atomic<uint64_t>;
+    using AllocTraits       = AllocatorTraits<ValueType, AllocatorType>;
+    using FlagAlloc         = typename AllocatorType::RebindAlloc<Word>;
+    using FlagAllocTraits   = AllocatorTraits<Word, FlagAlloc>;
+
+    static constexpr size_t first_shift = std::countr_zero(first_bucket);
+    static constexpr size_t max_buckets = 64 - first_shift;
+
+public:
+
+    ConcurrentArray() : reserved(0), alloc(), falloc() {}
+
+    ConcurrentArray(const ConcurrentArray&) = delete;
+    ConcurrentArray& operator=(const ConcurrentArray&) = delete;
+
+    // must not race with anything
+    ~ConcurrentArray() {
+        for (size_t k = 0; k < max_buckets; ++k) {
+            Pointer data = buckets[k].load(std::memory_order_relaxed);
+            Word* ready = flags[k].load(std::memory_order_relaxed);
+            SizeType n = first_bucket << k;
+            if (data && ready) {
+                for (SizeType i = 0; i < n; ++i) {
+                    if (ready[i / 64].load(std::memory_order_relaxed) >> (i % 64) & 1) {
+                        AllocTraits::destroy(alloc, data + i);
+                    }
+                }
+            }
+            if (data) AllocTraits::deallocate(alloc, data, n);
+            if (ready) FlagAllocTraits::deallocate(falloc, ready, Words(n));
+        }
+    }
+
+    // the index the element was placed at
+    template <typename... Args> requires std::constructible_from<ValueType, Args...>
+    SizeType emplace_back(Args&&... args) {
+        SizeType ind = reserved.fetch_add(1, std::memory_order_relaxed);
+        size_t k;
+        SizeType offset;
+        Locate(ind, k, offset);
+        Pointer data = Bucket(k);
+        Word* ready = Flags(k);
+        AllocTraits::construct(alloc, data + offset, std::forward<Args>(args)...);
+        ready[offset / 64].fetch_or(uint64_t(1) << (offset % 64), std::memory_order_release);
+        return ind;
+    }
+
+    SizeType append(const ValueType& val) {
+        return emplace_back(val);
+    }
+
+    SizeType append(ValueType&& val) {
+        return emplace_back(std::move(val));
+    }
+
+    // indices handed out so far; the latest of them may still be under construction
+    SizeType size() const noexcept {
+        return reserved.load(std::memory_order_acquire);
+    }
+
+    bool published(SizeType ind) const noexcept {
+        if (ind >= size()) return false;
+        size_t k;
+        SizeType offset;
+        Locate(ind, k, offset);
+        Word* ready = flags[k].load(std::memory_order_acquire);
+        return ready && (ready[offset / 64].load(std::memory_order_acquire) >> (offset % 64) & 1);
+    }
+
+    // ind must be published; checked mode verifies it
+    Reference operator[](SizeType ind) {
+        if constexpr (checked_access) {
+            if (!published(ind)) throw UndereferencableIterator();
+        }
+        size_t k;
+        SizeType offset;
+        Locate(ind, k, offset);
+        return buckets[k].load(std::memory_order_acquire)[offset];
+    }
+
+    ConstReference operator[](SizeType ind) const {
+        return const_cast<ConcurrentArray&>(*this)[ind];
+    }
+
+private:
+    static SizeType Words(SizeType n) noexcept {
+        return (n + 63) / 64;
+    }
+
+    static void Locate(SizeType ind, size_t& bucket, SizeType& offset) noexcept {
+        SizeType j = ind + first_bucket;
+        bucket = std::bit_width(j) - 1 - first_shift;
+        offset = j - (first_bucket << bucket);
+    }
+
+    Pointer Bucket(size_t k) {
+        Pointer data = buckets[k].load(std::memory_order_acquire);
+        if (data) return data;
+        Pointer mine = AllocTraits::allocate(alloc, first_bucket << k);
+        if (buckets[k].compare_exchange_strong(data, mine, std::memory_order_acq_rel)) return mine;
+        AllocTraits::deallocate(alloc, mine, first_bucket << k);
+        return data;
+    }
+
+    Word* Flags(size_t k) {
+        Word* ready = flags[k].load(std::memory_order_acquire);
+        if (ready) return ready;
+        SizeType n = Words(first_bucket << k);
+        Word* mine = FlagAllocTraits::allocate(falloc, n);
+        for (SizeType i = 0; i < n; ++i) FlagAllocTraits::construct(falloc, mine + i, 0);
+        if (flags[k].compare_exchange_strong(ready, mine, std::memory_order_acq_rel)) return mine;
+        FlagAllocTraits::deallocate(falloc, mine, n);
+        return ready;
+    }
+
+    std::atomic<SizeType> reserved;
+    std::atomic<Pointer> buckets[max_buckets] = {};
+    std::atomic<Word*> flags[max_buckets] = {};
+    AllocatorType alloc;
+    FlagAlloc falloc;
+};
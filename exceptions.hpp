@@ -47,3 +47,45 @@ public:
         return "Cannot get the element of the list because its empty";
     }
 };
+
+class EmptyCollection : public Exception {
+public:
+    const char* what() const noexcept override {
+        return "The collection is empty";
+    }
+};
+
+class FullCollection : public Exception {
+public:
+    const char* what() const noexcept override {
+        return "The collection is full";
+    }
+};
+
+class MappingError : public Exception {
+public:
+    const char* what() const noexcept override {
+        return "Cannot open or map the file";
+    }
+};
+
+class ReadOnlyCollection : public Exception {
+public:
+    const char* what() const noexcept override {
+        return "The collection is opened read-only";
+    }
+};
+
+class SnapshotError : public Exception {
+public:
+    const char* what() const noexcept override {
+        return "Cannot write the snapshot or it is malformed";
+    }
+};
+
+class InvalidView : public Exception {
+public:
+    const char* what() const noexcept override {
+        return "The view doesn't fit the collection";
+    }
+};
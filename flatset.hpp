@@ -0,0 +1,334 @@
+#pragma once
+
+#include "set.hpp"
+#include <algorithm>
+#include <utility>
+
+template <class K, class V>
+struct MapConverter {
+    const K& operator() (const std::pair<K, V>& val) const noexcept {
+        return val.first;
+    }
+};
+
+// Sorted unique values kept contiguously in an Array, with RBTree's lookup surface:
+// searches are a binary search over one block of memory instead of a walk through
+// heap nodes, and iteration is a plain scan. Inserting one value shifts the ones after
+// it, so these suit sets that are read far more often than changed; insert(first, last)
+// appends the whole range, sorts it and merges it in once. Of equivalent values the
+// one inserted first is kept. Any insertion or erasure invalidates iterators' positions.
+template <typename KType,
+            typename VType,
+            Converter<KType, VType> ConType,
+            Comparator<KType> CType = Less<KType>,
+            TAllocator AlType = Allocator<VType>>
+class FlatTree {
+public:
+    using KeyType           = KType;
+    using ValueType         = VType;
+    using Pointer           = VType*;
+    using ConstPointer      = const VType*;
+    using Reference         = VType&;
+    using ConstReference    = const VType&;
+    using AllocatorType     = AlType;
+    using ComparatorType    = CType;
+    using ArrayType         = Array<ValueType, AllocatorType>;
+    using SizeType          = typename ArrayType::SizeType;
+    using Iterator          = std::conditional_t<std::same_as<KeyType, ValueType>, typename ArrayType::ConstIterator, typename ArrayType::Iterator>;
+    using ConstIterator     = typename ArrayType::ConstIterator;
+
+    FlatTree() : vals(), comp(), conv() {}
+
+    FlatTree(const std::initializer_list<ValueType>& ls) : FlatTree() {
+        InsertRange(ls.begin(), ls.end());
+    }
+
+    template <IsForwardIterator<ValueType> Iter>
+    FlatTree(Iter first, Iter last) : FlatTree() {
+        insert(first, last);
+    }
+
+    SizeType size() const noexcept {
+        return vals.size();
+    }
+
+    SizeType capacity() const noexcept {
+        return vals.capacity();
+    }
+
+    void reserve(SizeType n) {
+        vals.reserve(n);
+    }
+
+    Iterator begin() noexcept {
+        return Begin();
+    }
+
+    Iterator end() noexcept {
+        return Begin() + vals.size();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return vals.cbegin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return vals.cend();
+    }
+
+    Iterator find(const KeyType& key) noexcept {
+        return Begin() + Find(key);
+    }
+
+    ConstIterator find(const KeyType& key) const noexcept {
+        return vals.cbegin() + Find(key);
+    }
+
+    Iterator lower_bound(const KeyType& key) noexcept {
+        return Begin() + LowerBound(key);
+    }
+
+    ConstIterator lower_bound(const KeyType& key) const noexcept {
+        return vals.cbegin() + LowerBound(key);
+    }
+
+    Iterator upper_bound(const KeyType& key) noexcept {
+        return Begin() + UpperBound(key);
+    }
+
+    ConstIterator upper_bound(const KeyType& key) const noexcept {
+        return vals.cbegin() + UpperBound(key);
+    }
+
+    std::pair<Iterator, Iterator> equal_range(const KeyType& key) noexcept {
+        SizeType first = LowerBound(key);
+        SizeType last = first + (first != vals.size() && !comp(key, conv(Data()[first])));
+        return std::make_pair(Begin() + first, Begin() + last);
+    }
+
+    std::pair<ConstIterator, ConstIterator> equal_range(const KeyType& key) const noexcept {
+        SizeType first = LowerBound(key);
+        SizeType last = first + (first != vals.size() && !comp(key, conv(Data()[first])));
+        return std::make_pair(vals.cbegin() + first, vals.cbegin() + last);
+    }
+
+    SizeType count(const KeyType& key) const noexcept {
+        return contains(key);
+    }
+
+    bool contains(const KeyType& key) const noexcept {
+        return Find(key) != vals.size();
+    }
+
+    // false if an equivalent value is already there
+    bool insert(ConstReference val) {
+        return Insert(val);
+    }
+
+    bool insert(ValueType&& val) {
+        return Insert(std::move(val));
+    }
+
+    template <typename... Args>
+    bool emplace(Args&&... args) {
+        return Insert(ValueType(std::forward<Args>(args)...));
+    }
+
+    // appends the range, sorts it (stably, so the first of equivalent values stays first)
+    // and merges it with the values already there, O((n + m) log m) instead of m shifts
+    template <IsForwardIterator<ValueType> Iter>
+    void insert(Iter first, Iter last) {
+        InsertRange(first, last);
+    }
+
+    // the number of values removed, 0 or 1
+    SizeType erase(const KeyType& key) {
+        SizeType ind = Find(key);
+        if (ind == vals.size()) return 0;
+        vals.erase(vals.begin() + ind, vals.begin() + ind + 1);
+        return 1;
+    }
+
+    void erase(Iterator iterator) {
+        EraseRange(iterator - Begin(), iterator - Begin() + 1);
+    }
+
+    void erase(ConstIterator iterator) requires (!std::same_as<KeyType, ValueType>) {
+        EraseRange(iterator - vals.cbegin(), iterator - vals.cbegin() + 1);
+    }
+
+    void erase(Iterator first, Iterator last) {
+        EraseRange(first - Begin(), last - Begin());
+    }
+
+    void erase(ConstIterator first, ConstIterator last) requires (!std::same_as<KeyType, ValueType>) {
+        EraseRange(first - vals.cbegin(), last - vals.cbegin());
+    }
+
+    void clear() {
+        vals = ArrayType();
+    }
+
+protected:
+    Iterator Begin() noexcept {
+        if constexpr (std::same_as<KeyType, ValueType>) {
+            return vals.cbegin();
+        } else {
+            return vals.begin();
+        }
+    }
+
+    Pointer Data() const noexcept {
+        return (vals.size() ? const_cast<Pointer>(&*vals.cbegin()) : nullptr);
+    }
+
+    // index of the first value not less than key; the halving loop has no unpredictable branch
+    SizeType LowerBound(const KeyType& key) const noexcept {
+        ConstPointer data = Data(), base = data;
+        SizeType n = vals.size();
+        if (n == 0) return 0;
+        while (n > 1) {
+            SizeType half = n / 2;
+            base = (comp(conv(base[half - 1]), key) ? base + half : base);
+            n -= half;
+        }
+        return base - data + comp(conv(*base), key);
+    }
+
+    SizeType UpperBound(const KeyType& key) const noexcept {
+        ConstPointer data = Data(), base = data;
+        SizeType n = vals.size();
+        if (n == 0) return 0;
+        while (n > 1) {
+            SizeType half = n / 2;
+            base = (comp(key, conv(base[half - 1])) ? base : base + half);
+            n -= half;
+        }
+        return base - data + !comp(key, conv(*base));
+    }
+
+    // index of the value equivalent to key, size() if there is none
+    SizeType Find(const KeyType& key) const noexcept {
+        SizeType ind = LowerBound(key);
+        return (ind != vals.size() && !comp(key, conv(Data()[ind])) ? ind : vals.size());
+    }
+
+    void EraseRange(SizeType from, SizeType to) {
+        if (from < to) vals.erase(vals.begin() + from, vals.begin() + to);
+    }
+
+    // the new values are sorted apart and merged into a fresh array which replaces vals
+    // only at the end, so a throwing copy or comparison leaves the tree as it was
+    template <typename Iter>
+    void InsertRange(Iter first, Iter last) {
+        ArrayType added;
+        for (; first != last; ++first) added.append(*first);
+        if (added.size() == 0) return;
+        auto less = [this](ConstReference a, ConstReference b) { return comp(conv(a), conv(b)); };
+        Pointer src = &*added.begin();
+        std::stable_sort(src, src + added.size(), less);
+        added.unique([this](ConstReference a, ConstReference b) { return !comp(conv(a), conv(b)); });
+        if (vals.size() == 0) {
+            vals = std::move(added);
+            return;
+        }
+        ArrayType merged;
+        merged.reserve(vals.size() + added.size());
+        ConstPointer data = Data();
+        SizeType i = 0, j = 0;
+        while (i < vals.size() && j < added.size()) {
+            if (less(src[j], data[i])) {
+                merged.append(std::move(src[j++]));
+            } else {
+                // an equivalent value already there wins over the new one
+                if (!less(data[i], src[j])) ++j;
+                merged.append(data[i++]);
+            }
+        }
+        for (; i < vals.size(); ++i) merged.append(data[i]);
+        for (; j < added.size(); ++j) merged.append(std::move(src[j]));
+        vals = std::move(merged);
+    }
+
+    template <typename V>
+    bool Insert(V&& val) {
+        SizeType ind = LowerBound(conv(val));
+        if (ind != vals.size() && !comp(conv(val), conv(Data()[ind]))) return false;
+        vals.emplace(vals.begin() + ind, std::forward<V>(val));
+        return true;
+    }
+
+    ArrayType vals;
+    ComparatorType comp;
+    ConType conv;
+};
+
+template <typename KType,
+            Comparator<KType> CType = Less<KType>,
+            TAllocator AlType = Allocator<KType>>
+class FlatSet : public FlatTree<KType, KType, SetConverter<KType>, CType, AlType> {
+public:
+    using Base              = FlatTree<KType, KType, SetConverter<KType>, CType, AlType>;
+    using KeyType           = typename Base::KeyType;
+    using ValueType         = typename Base::ValueType;
+    using SizeType          = typename Base::SizeType;
+    using Iterator          = typename Base::Iterator;
+    using ConstIterator     = typename Base::ConstIterator;
+
+    FlatSet() : Base() {}
+    FlatSet(const std::initializer_list<KeyType>& list) : Base(list) {}
+    template <IsForwardIterator<KeyType> Iter>
+    FlatSet(Iter first, Iter last) : Base(first, last) {}
+
+    FlatSet& operator+= (const FlatSet& other) {
+        Base::insert(other.cbegin(), other.cend());
+        return *this;
+    }
+
+    FlatSet operator+ (const FlatSet& other) const {
+        FlatSet res = *this;
+        res += other;
+        return res;
+    }
+};
+
+// Values are (key, mapped) pairs; keys must not be changed through the iterators.
+template <typename KType,
+            typename MType,
+            Comparator<KType> CType = Less<KType>,
+            TAllocator AlType = Allocator<std::pair<KType, MType>>>
+class FlatMap : public FlatTree<KType, std::pair<KType, MType>, MapConverter<KType, MType>, CType, AlType> {
+public:
+    using Base              = FlatTree<KType, std::pair<KType, MType>, MapConverter<KType, MType>, CType, AlType>;
+    using KeyType           = typename Base::KeyType;
+    using MappedType        = MType;
+    using ValueType         = typename Base::ValueType;
+    using SizeType          = typename Base::SizeType;
+    using Iterator          = typename Base::Iterator;
+    using ConstIterator     = typename Base::ConstIterator;
+
+    FlatMap() : Base() {}
+    FlatMap(const std::initializer_list<ValueType>& list) : Base(list) {}
+    template <IsForwardIterator<ValueType> Iter>
+    FlatMap(Iter first, Iter last) : Base(first, last) {}
+
+    // the value mapped to key, inserted default-constructed if missing
+    MappedType& operator[] (const KeyType& key) requires std::default_initializable<MappedType> {
+        SizeType ind = Base::LowerBound(key);
+        if (ind == this->vals.size() || this->comp(key, this->Data()[ind].first)) {
+            this->vals.emplace(this->vals.begin() + ind, key, MappedType());
+        }
+        return this->Data()[ind].second;
+    }
+
+    // the value mapped to key, which must be there
+    MappedType& at(const KeyType& key) {
+        SizeType ind = Base::Find(key);
+        if (ind == this->vals.size()) throw UndereferencableIterator();
+        return this->Data()[ind].second;
+    }
+
+    const MappedType& at(const KeyType& key) const {
+        return const_cast<FlatMap&>(*this).at(key);
+    }
+};
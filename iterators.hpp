@@ -1,5 +1,23 @@
 #pragma once
 
+#include <cstddef>
+#include <concepts>
+#include <type_traits>
+
+// Bounds and origin checks of array iterators and the index wrapping of Array::operator[]
+// are on by default. Building with -DUNCHECKED_ACCESS turns them into plain pointer
+// arithmetic with no branches; Array::at() keeps wrapping indices either way.
+#ifdef UNCHECKED_ACCESS
+inline constexpr bool checked_access = false;
+#else
+inline constexpr bool checked_access = true;
+#endif
+
+// Iterator categories are empty, non-virtual bases: they only carry the member types
+// and mark the category. The operations each category needs are checked by the
+// Is...Iterator concepts below, so concrete iterators are plain classes whose
+// operators take and return their own type and inline into the calling loop.
+
 template <typename VType>
 class ForwardIterator {
 public:
@@ -7,23 +25,9 @@ public:
     using Pointer           = ValueType*;
     using ConstPointer      = const ValueType*;
     using Reference         = ValueType&;
-    using ConstReference    = const Reference&;
+    using ConstReference    = const ValueType&;
     using SizeType          = size_t;
     using RightReference    = ValueType&&;
-
-    // dereferencing
-
-    virtual Reference operator*() const = 0;
-    virtual Pointer operator->() const = 0;
-
-    // checking for equality/unequality
-
-    virtual bool operator==(const ForwardIterator&) const noexcept = 0;
-    virtual bool operator!=(const ForwardIterator&) const noexcept = 0;
-
-    // increment
-
-    virtual ForwardIterator& operator++() = 0;
 };
 
 template <typename VType>
@@ -33,23 +37,9 @@ public:
     using Pointer           = ValueType*;
     using ConstPointer      = const ValueType*;
     using Reference         = ValueType&;
-    using ConstReference    = const Reference&;
+    using ConstReference    = const ValueType&;
     using SizeType          = size_t;
     using RightReference    = ValueType&&;
-
-    // dereferencing
-
-    virtual ConstReference operator*() const = 0;
-    virtual ConstPointer operator->() const = 0;
-
-    // checking for equality/unequality
-
-    virtual bool operator==(const ConstForwardIterator&) const noexcept = 0;
-    virtual bool operator!=(const ConstForwardIterator&) const noexcept = 0;
-
-    // increment
-
-    virtual ConstForwardIterator& operator++() = 0;
 };
 
 template <typename VType>
@@ -63,8 +53,6 @@ public:
     using ConstReference    = typename Base::ConstReference;
     using SizeType          = typename Base::SizeType;
     using RightReference    = typename Base::RightReference;
-
-    virtual BidirectionalIterator& operator--() = 0;
 };
 
 template <typename VType>
@@ -78,8 +66,6 @@ public:
     using ConstReference    = typename Base::ConstReference;
     using SizeType          = typename Base::SizeType;
     using RightReference    = typename Base::RightReference;
-
-    virtual ConstBidirectionalIterator& operator--() = 0;
 };
 
 template <typename VType>
@@ -94,14 +80,6 @@ public:
     using SizeType          = typename Base::SizeType;
     using ItDiff            = int;
     using RightReference    = typename Base::RightReference;
-
-    virtual RandomAccessIterator& operator+= (ItDiff) = 0;
-    virtual RandomAccessIterator& operator-= (ItDiff) = 0;
-    virtual ItDiff operator- (const RandomAccessIterator&) const = 0;
-    virtual bool operator> (const RandomAccessIterator&) const = 0;
-    virtual bool operator< (const RandomAccessIterator&) const = 0;
-    virtual bool operator>= (const RandomAccessIterator&) const = 0;
-    virtual bool operator<= (const RandomAccessIterator&) const = 0;
 };
 
 template <typename VType>
@@ -116,21 +94,39 @@ public:
     using SizeType          = typename Base::SizeType;
     using ItDiff            = int;
     using RightReference    = typename Base::RightReference;
+};
 
-    virtual ConstRandomAccessIterator& operator+= (int) = 0;
-    virtual ConstRandomAccessIterator& operator-= (int) = 0;
-    virtual ItDiff operator- (const ConstRandomAccessIterator&) const = 0;
-    virtual bool operator> (const ConstRandomAccessIterator&) const = 0;
-    virtual bool operator< (const ConstRandomAccessIterator&) const = 0;
-    virtual bool operator>= (const ConstRandomAccessIterator&) const = 0;
-    virtual bool operator<= (const ConstRandomAccessIterator&) const = 0;
+template <class T, class VT>
+concept IsForwardIterator = (std::derived_from<T, ForwardIterator<VT>> || std::derived_from<T, ConstForwardIterator<VT>>)
+    && std::equality_comparable<T> && requires (T it) {
+    *it;
+    // a proxy iterator (one whose * gives a value, like BitArray's) has nothing for -> to point at
+    requires !std::is_reference_v<decltype(*it)> || requires { it.operator->(); };
+    {++it} -> std::same_as<T&>;
 };
 
 template <class T, class VT>
-concept IsForwardIterator = std::derived_from<T, ForwardIterator<VT>> || std::derived_from<T, ConstForwardIterator<VT>>;
+concept IsBidirectionalIterator = IsForwardIterator<T, VT>
+    && (std::derived_from<T, BidirectionalIterator<VT>> || std::derived_from<T, ConstBidirectionalIterator<VT>>)
+    && requires (T it) {
+    {--it} -> std::same_as<T&>;
+};
 
 template <class T, class VT>
-concept IsBidirectionalIterator = std::derived_from<T, BidirectionalIterator<VT>> || std::derived_from<T, ConstBidirectionalIterator<VT>>;
+concept IsRandomAccessIterator = IsBidirectionalIterator<T, VT>
+    && (std::derived_from<T, RandomAccessIterator<VT>> || std::derived_from<T, ConstRandomAccessIterator<VT>>)
+    && requires (T it, typename T::ItDiff n) {
+    {it += n} -> std::same_as<T&>;
+    {it -= n} -> std::same_as<T&>;
+    {it + n} -> std::same_as<T>;
+    {it - n} -> std::same_as<T>;
+    {it - it} -> std::same_as<typename T::ItDiff>;
+    {it < it} -> std::same_as<bool>;
+};
 
+// random access iterators over one contiguous block, where it + n addresses &*it + n;
+// such iterators declare static constexpr bool is_contiguous = true
 template <class T, class VT>
-concept IsRandomAccessIterator = std::derived_from<T, RandomAccessIterator<VT>> || std::derived_from<T, ConstRandomAccessIterator<VT>>;
+concept IsContiguousIterator = IsRandomAccessIterator<T, VT> && requires {
+    requires T::is_contiguous;
+};
@@ -1,8 +1,12 @@
+#pragma once
+
 #include "iterators.hpp"
 #include "exceptions.hpp"
 #include "allocator.hpp"
 #include "altraits.hpp"
+#include "snapshot.hpp"
 #include <concepts>
+#include <functional>
 #include <initializer_list>
 
 template <std::default_initializable VType, TAllocator AlType>
@@ -13,7 +17,7 @@ struct listNode {
     listNode* prev;
     listNode* next;
     VType val;
-    template <std::constructible_from<VType> ...Args>
+    template <typename... Args> requires std::constructible_from<VType, Args...>
     listNode(listNode* prev, listNode* next, Args&&... args): prev(prev), next(next), val(std::forward<Args>(args)...) {}
 };
 
@@ -33,28 +37,23 @@ public:
     template <std::default_initializable VT, TAllocator AlType>
     friend class List;
 
-    listIterator(const Base& it) : listIterator(static_cast<const listIterator&>(it)) {}
-    listIterator(const ForwardIterator<ValueType>& it) : listIterator(static_cast<const listIterator&>(it)){}
-
-    Reference operator*() const override {
+    Reference operator*() const {
         if (node->next != nullptr) return node->val;
         else throw UndereferencableIterator();
     }
-    Pointer operator->() const override {
+    Pointer operator->() const {
         if (node->next != nullptr) return &(node->val);
         else throw UndereferencableIterator();
     }
 
-    bool operator== (const ForwardIterator<ValueType>& other) const noexcept override {
-        auto it = static_cast<const listIterator&>(other);
-        return node == it.node;
+    bool operator== (const listIterator& other) const noexcept {
+        return node == other.node;
     }
-    bool operator!= (const ForwardIterator<ValueType>& other) const noexcept override {
-        auto it = static_cast<const listIterator&>(other);
-        return node != it.node;
+    bool operator!= (const listIterator& other) const noexcept {
+        return node != other.node;
     }
 
-    ForwardIterator<ValueType>& operator++() override {
+    listIterator& operator++() {
         if (node->next != nullptr) {
             node = node->next;
             return *this;
@@ -66,7 +65,7 @@ public:
             return listIterator(node->prev);
         } else throw IteratorOutOfBounds();
     }
-    Base& operator--() override {
+    listIterator& operator--() {
         if (node->prev != nullptr) {
             node = node->prev;
             return *this;
@@ -99,24 +98,22 @@ public:
     template <std::default_initializable VT, TAllocator AlType>
     friend class List;
 
-    ConstReference operator*() const override {
+    ConstReference operator*() const {
         if (node->next != nullptr) return node->val;
         else throw UndereferencableIterator();
     }
-    ConstPointer operator->() const override {
+    ConstPointer operator->() const {
         if (node->next != nullptr) return &(node->val);
         else throw UndereferencableIterator();
     }
 
-    bool operator== (const ConstForwardIterator<ValueType>& other) const noexcept override {
-        auto it = static_cast<const constListIterator&>(other);
-        return node == it.node;
+    bool operator== (const constListIterator& other) const noexcept {
+        return node == other.node;
     }
-    bool operator!= (const ConstForwardIterator<ValueType>& other) const noexcept override {
-        auto it = static_cast<const constListIterator&>(other);
-        return node != it.node;
+    bool operator!= (const constListIterator& other) const noexcept {
+        return node != other.node;
     }
-    ConstForwardIterator<ValueType>& operator++() override {
+    constListIterator& operator++() {
         if (node->next != nullptr) {
             node = node->next;
             return *this;
@@ -125,10 +122,10 @@ public:
     constListIterator operator++(int) {
         if (node->next != nullptr) {
             node = node->next;
-            return listIterator(node->prev);
+            return constListIterator(node->prev);
         } else throw IteratorOutOfBounds();
     }
-    Base& operator--() override {
+    constListIterator& operator--() {
         if (node->prev != nullptr) {
             node = node->prev;
             return *this;
@@ -137,7 +134,7 @@ public:
     constListIterator operator--(int) {
         if (node->prev != nullptr) {
             node = node->prev;
-            return listIterator(node->next);
+            return constListIterator(node->next);
         } else throw IteratorOutOfBounds();
     }
 private:
@@ -228,12 +225,17 @@ public:
     }
     List(const List& other) : List(other.cbegin(), other.cend()) {}
     List(List&& other) : List() {
-        head = other.head;
-        tail = other.tail;
-        _size = other._size;
+        // nodes belong to the node allocator, so it has to travel with them
+        std::swap(head, other.head);
+        std::swap(tail, other.tail);
+        std::swap(_size, other._size);
+        std::swap(nalloc, other.nalloc);
     }
 
     ~List() {
+        if constexpr (NodeAllocTraits::skip_teardown) {
+            return;
+        }
         while (tail != head) {
             tail = tail->prev;
             NodeAllocTraits::deallocate(nalloc, tail->next, 1);
@@ -397,6 +399,62 @@ public:
             return tail->prev->val;
         } else throw UndereferencableIterator();
     }
+
+    // unlinks the elements satisfying pred and returns how many went away; nothing else moves
+    template <std::predicate<const ValueType&> Pred>
+    SizeType erase_if(Pred pred) {
+        SizeType removed = 0;
+        for (Node* node = head; node != tail;) {
+            Node* next = node->next;
+            if (pred(node->val)) {
+                erase(Iterator(node));
+                ++removed;
+            }
+            node = next;
+        }
+        return removed;
+    }
+
+    // a list has nothing to compact, so as with std::list this erases right away
+    template <std::predicate<const ValueType&> Pred>
+    SizeType remove_if(Pred pred) {
+        return erase_if(pred);
+    }
+
+    // removes every element equal to the one kept before it, returns how many went away
+    template <typename Eq = std::equal_to<ValueType>> requires std::predicate<Eq, const ValueType&, const ValueType&>
+    SizeType unique(Eq eq = Eq()) {
+        SizeType removed = 0;
+        if (_size == 0) return 0;
+        for (Node* node = head->next; node != tail;) {
+            Node* next = node->next;
+            if (eq(node->prev->val, node->val)) {
+                erase(Iterator(node));
+                ++removed;
+            }
+            node = next;
+        }
+        return removed;
+    }
+
+    // binary snapshot, see snapshot.hpp
+    void save(std::ostream& out) const requires Serializable<ValueType> {
+        SnapshotHeader::write(out, SnapshotKind::List, snapshot_value_size<ValueType>, _size);
+        SnapshotBuffer<ValueType>::write(out, cbegin(), cend());
+    }
+
+    // the nodes are swapped in only after the whole snapshot has been read
+    void load(std::istream& in) requires Serializable<ValueType> {
+        uint64_t n = SnapshotHeader::read(in, SnapshotKind::List, snapshot_value_size<ValueType>);
+        List loaded;
+        SnapshotBuffer<ValueType>::read(in, n, [&loaded](ValueType&& val) {
+            loaded.append(std::move(val));
+        });
+        std::swap(head, loaded.head);
+        std::swap(tail, loaded.tail);
+        std::swap(_size, loaded._size);
+        std::swap(nalloc, loaded.nalloc);
+    }
 private:
     Node *head, *tail;
     SizeType _size;
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "array.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Array over a file of raw VType records mapped with mmap: opening only sets up the
+// mapping, pages are read in on first access and shared with the page cache.
+// ReadOnly maps the file privately, so writes stay in this process and append throws;
+// ReadWrite maps it shared, creates the file if it's missing and grows it on append.
+// While open the file holds capacity() records, it is cut down to size() on close.
+template <std::default_initializable VType> requires std::is_trivially_copyable_v<VType>
+class MappedArray {
+
+public:
+    using ValueType             = VType;
+    using Pointer               = ValueType*;
+    using Reference             = ValueType&;
+    using ConstPointer          = const ValueType*;
+    using ConstReference        = const ValueType&;
+    using GrowthType            = DoubleGrowth;
+    using Iterator              = arrayIterator<ValueType>;
+    using ConstIterator         = constArrayIterator<ValueType>;
+    using SizeType              = typename Iterator::SizeType;
+    using ItDiff                = typename Iterator::ItDiff;
+    using SliceType             = Slice<ValueType>;
+
+    enum class Mode { ReadOnly, ReadWrite };
+
+    explicit MappedArray(const char* path, Mode mode = Mode::ReadOnly) : arr(nullptr), _size(0), cap(0), fd(-1), mode(mode) {
+        fd = ::open(path, mode == Mode::ReadOnly ? O_RDONLY : O_RDWR | O_CREAT, 0644);
+        if (fd < 0) throw MappingError();
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw MappingError();
+        }
+        _size = cap = st.st_size / sizeof(ValueType);
+        if (cap != 0) {
+            arr = Map(cap);
+            if (!arr) {
+                ::close(fd);
+                throw MappingError();
+            }
+        }
+    }
+
+    MappedArray(const MappedArray&) = delete;
+    MappedArray& operator=(const MappedArray&) = delete;
+
+    MappedArray(MappedArray&& other) noexcept : arr(nullptr), _size(0), cap(0), fd(-1), mode(other.mode) {
+        std::swap(arr, other.arr);
+        std::swap(_size, other._size);
+        std::swap(cap, other.cap);
+        std::swap(fd, other.fd);
+    }
+
+    ~MappedArray() {
+        if (arr) munmap(arr, cap*sizeof(ValueType));
+        if (fd >= 0) {
+            if (mode == Mode::ReadWrite) (void)::ftruncate(fd, _size*sizeof(ValueType));
+            ::close(fd);
+        }
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(arr, _size, 0);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return ConstIterator(arr, _size, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(arr, _size, _size);
+    }
+
+    ConstIterator cend() const noexcept {
+        return ConstIterator(arr, _size, _size);
+    }
+
+    SizeType size() const noexcept {
+        return _size;
+    }
+
+    SizeType capacity() const noexcept {
+        return cap;
+    }
+
+    bool read_only() const noexcept {
+        return mode == Mode::ReadOnly;
+    }
+
+    void append(const ValueType& val) {
+        if (mode == Mode::ReadOnly) throw ReadOnlyCollection();
+        if (_size == cap) {
+            ValueType copy = val;
+            Remap(GrowthType::next(cap, _size + 1));
+            arr[_size++] = copy;
+        } else {
+            arr[_size++] = val;
+        }
+    }
+
+    void pop() {
+        if (_size == 0) throw NothingToErase();
+        --_size;
+    }
+
+    void reserve(SizeType n) {
+        if (mode == Mode::ReadOnly) throw ReadOnlyCollection();
+        if (n > cap) Remap(n);
+    }
+
+    // writes the changed pages back to the file and waits for it
+    void flush() {
+        if (arr && mode == Mode::ReadWrite && msync(arr, cap*sizeof(ValueType), MS_SYNC) != 0) {
+            throw MappingError();
+        }
+    }
+
+    // index taken modulo size, negative indices count from the end
+    ValueType& at(ItDiff ind) noexcept {
+        if (ind >= 0) {
+            return *(arr + (ind % _size));
+        } else {
+            return *(arr + (_size + ind % ItDiff(_size)) % _size);
+        }
+    }
+
+    // wraps like at() in checked mode, plain offset in unchecked mode
+    ValueType& operator[](ItDiff ind) noexcept {
+        if constexpr (checked_access) {
+            return at(ind);
+        } else {
+            return *(arr + ind);
+        }
+    }
+
+    SliceType slice(SizeType from, SizeType to)  {
+        if (from > to) return SliceType(arr + _size, 0);
+        else return SliceType(arr + from, to - from);
+    }
+private:
+    Pointer Map(SizeType n) noexcept {
+        void* res = mmap(nullptr, n*sizeof(ValueType), PROT_READ | PROT_WRITE,
+                         mode == Mode::ReadOnly ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+        return res == MAP_FAILED ? nullptr : static_cast<Pointer>(res);
+    }
+
+    // extends the file to n records and maps all of them
+    void Remap(SizeType n) {
+        if (::ftruncate(fd, n*sizeof(ValueType)) != 0) throw MappingError();
+        Pointer newarr = nullptr;
+#ifdef __linux__
+        if (arr) {
+            void* res = mremap(arr, cap*sizeof(ValueType), n*sizeof(ValueType), MREMAP_MAYMOVE);
+            newarr = (res == MAP_FAILED ? nullptr : static_cast<Pointer>(res));
+        } else {
+            newarr = Map(n);
+        }
+#else
+        newarr = Map(n);
+        if (newarr && arr) munmap(arr, cap*sizeof(ValueType));
+#endif
+        if (!newarr) throw MappingError();
+        arr = newarr;
+        cap = n;
+    }
+
+    Pointer arr;
+    SizeType _size, cap;
+    int fd;
+    Mode mode;
+};
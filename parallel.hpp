@@ -0,0 +1,336 @@
+#pragma once
+
+#include "array.hpp"
+#include "compare.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
+#include <thread>
+
+// Fixed set of worker threads running one indexed job at a time: run(count, f)
+// calls f(0) ... f(count - 1) on the workers and the calling thread, handing out
+// indices dynamically, and returns once all of them are done. Jobs must not throw
+// and must not call run() on the same pool.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency()) : current(nullptr), generation(0), stop(false) {
+        for (size_t i = 1; i < threads; ++i) {
+            workers.append(std::thread([this] { Work(); }));
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto it = workers.begin(); it != workers.end(); ++it) {
+            it->join();
+        }
+    }
+
+    // number of threads taking part in a job, the caller included
+    size_t size() const noexcept {
+        return workers.size() + 1;
+    }
+
+    template <typename F>
+    void run(size_t count, F&& f) {
+        if (count == 1 || workers.size() == 0) {
+            for (size_t i = 0; i < count; ++i) f(i);
+            return;
+        } else if (count == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> serial(running);
+        Job job(count, &f, [](void* ctx, size_t i) {
+            (*static_cast<std::remove_reference_t<F>*>(ctx))(i);
+        });
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            current = &job;
+            ++generation;
+        }
+        wake.notify_all();
+        Execute(job);
+        // every index is taken by now, wait for the workers still running theirs
+        std::unique_lock<std::mutex> guard(lock);
+        done.wait(guard, [&job] { return job.active == 0; });
+        current = nullptr;
+    }
+
+private:
+    struct Job {
+        Job(size_t count, void* ctx, void (*call)(void*, size_t)) : count(count), next(0), active(0), ctx(ctx), call(call) {}
+
+        size_t count;
+        std::atomic<size_t> next;
+        size_t active;      // workers inside the job, guarded by lock
+        void* ctx;
+        void (*call)(void*, size_t);
+    };
+
+    static void Execute(Job& job) {
+        for (size_t i = job.next.fetch_add(1); i < job.count; i = job.next.fetch_add(1)) {
+            job.call(job.ctx, i);
+        }
+    }
+
+    void Work() {
+        size_t seen = 0;
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            wake.wait(guard, [this, &seen] { return stop || (current && generation != seen); });
+            if (stop) return;
+            seen = generation;
+            Job* job = current;
+            ++job->active;
+            guard.unlock();
+            Execute(*job);
+            guard.lock();
+            if (--job->active == 0) done.notify_all();
+        }
+    }
+
+    Array<std::thread> workers;
+    std::mutex lock, running;
+    std::condition_variable wake, done;
+    Job* current;
+    size_t generation;
+    bool stop;
+};
+
+// Parallel algorithms over random access ranges (Array, Slice or their iterators).
+// Ranges are split into chunks of at least grain elements which are spread over the
+// pool's threads. Contiguous ranges are walked through raw pointers, any other
+// random access range through its iterators; sorting one of those sorts a
+// contiguous copy and moves it back.
+class Parallel {
+public:
+    static constexpr size_t default_grain = 1 << 14;
+
+    explicit Parallel(size_t threads = std::thread::hardware_concurrency(), size_t grain = default_grain)
+        : pool(threads), grain(grain ? grain : 1) {}
+
+    size_t threads() const noexcept {
+        return pool.size();
+    }
+
+    template <typename It, typename F> requires IsRandomAccessIterator<It, typename It::ValueType>
+    void for_each(It first, It last, F f) {
+        auto data = Data(first, last);
+        ForChunks(last - first, [&](size_t from, size_t to) {
+            for (size_t i = from; i < to; ++i) f(data[i]);
+        });
+    }
+
+    // out may be first itself
+    template <typename It, typename Out, typename F>
+        requires IsRandomAccessIterator<It, typename It::ValueType> && IsRandomAccessIterator<Out, typename Out::ValueType>
+    void transform(It first, It last, Out out, F f) {
+        auto data = Data(first, last);
+        auto res = Data(out, out + (last - first));
+        ForChunks(last - first, [&](size_t from, size_t to) {
+            for (size_t i = from; i < to; ++i) res[i] = f(data[i]);
+        });
+    }
+
+    // op must be associative; partial results are combined in order
+    template <typename It, typename T, typename Op = Plus<T>> requires IsRandomAccessIterator<It, typename It::ValueType>
+    T reduce(It first, It last, T init, Op op = Op()) {
+        size_t n = last - first, chunks = Chunks(n);
+        auto data = Data(first, last);
+        Array<T> partial(chunks);
+        pool.run(chunks, [&](size_t k) {
+            size_t from = Bound(n, chunks, k), to = Bound(n, chunks, k + 1);
+            T acc = data[from];
+            for (size_t i = from + 1; i < to; ++i) acc = op(acc, data[i]);
+            partial[k] = acc;
+        });
+        for (size_t k = 0; k < chunks; ++k) init = op(init, partial[k]);
+        return init;
+    }
+
+    // out[i] = data[0] op ... op data[i]; op must be associative, out may be first itself
+    template <typename It, typename Out, typename Op = Plus<typename It::ValueType>>
+        requires IsRandomAccessIterator<It, typename It::ValueType> && IsRandomAccessIterator<Out, typename Out::ValueType>
+    void inclusive_scan(It first, It last, Out out, Op op = Op()) {
+        using T = typename Out::ValueType;
+        size_t n = last - first, chunks = Chunks(n);
+        auto data = Data(first, last);
+        auto res = Data(out, out + n);
+        Array<T> offset(chunks);
+        pool.run(chunks, [&](size_t k) {
+            size_t from = Bound(n, chunks, k), to = Bound(n, chunks, k + 1);
+            T acc = data[from];
+            for (size_t i = from + 1; i < to; ++i) acc = op(acc, data[i]);
+            offset[k] = acc;
+        });
+        for (size_t k = 1; k + 1 < chunks; ++k) offset[k] = op(offset[k - 1], offset[k]);
+        pool.run(chunks, [&](size_t k) {
+            size_t from = Bound(n, chunks, k), to = Bound(n, chunks, k + 1);
+            res[from] = (k == 0 ? T(data[from]) : op(offset[k - 1], data[from]));
+            for (size_t i = from + 1; i < to; ++i) res[i] = op(res[i - 1], data[i]);
+        });
+    }
+
+    template <typename Container, typename F>
+        requires IsRandomAccessIterator<typename Container::Iterator, typename Container::ValueType>
+    void for_each(Container& c, F f) {
+        for_each(c.begin(), c.end(), f);
+    }
+
+    // out must hold at least as many elements as in, and may be in itself
+    template <typename Container, typename OutContainer, typename F>
+        requires IsRandomAccessIterator<typename Container::ConstIterator, typename Container::ValueType>
+            && IsRandomAccessIterator<typename OutContainer::Iterator, typename OutContainer::ValueType>
+    void transform(const Container& in, OutContainer& out, F f) {
+        transform(in.cbegin(), in.cend(), out.begin(), f);
+    }
+
+    template <typename Container, typename T, typename Op = Plus<T>>
+        requires IsRandomAccessIterator<typename Container::ConstIterator, typename Container::ValueType>
+    T reduce(const Container& c, T init, Op op = Op()) {
+        return reduce(c.cbegin(), c.cend(), init, op);
+    }
+
+    // out must hold at least as many elements as in, and may be in itself
+    template <typename Container, typename OutContainer, typename Op = Plus<typename OutContainer::ValueType>>
+        requires IsRandomAccessIterator<typename Container::ConstIterator, typename Container::ValueType>
+            && IsRandomAccessIterator<typename OutContainer::Iterator, typename OutContainer::ValueType>
+    void inclusive_scan(const Container& in, OutContainer& out, Op op = Op()) {
+        inclusive_scan(in.cbegin(), in.cend(), out.begin(), op);
+    }
+
+    template <typename It, typename Comp = Less<typename It::ValueType>> requires IsRandomAccessIterator<It, typename It::ValueType>
+    void sort(It first, It last, Comp comp = Comp()) {
+        Sort<false>(first, last, comp);
+    }
+
+    template <typename It, typename Comp = Less<typename It::ValueType>> requires IsRandomAccessIterator<It, typename It::ValueType>
+    void stable_sort(It first, It last, Comp comp = Comp()) {
+        Sort<true>(first, last, comp);
+    }
+
+    template <typename Container, typename Comp = Less<typename Container::ValueType>>
+        requires IsRandomAccessIterator<typename Container::Iterator, typename Container::ValueType>
+    void sort(Container& c, Comp comp = Comp()) {
+        Sort<false>(c.begin(), c.end(), comp);
+    }
+
+    template <typename Container, typename Comp = Less<typename Container::ValueType>>
+        requires IsRandomAccessIterator<typename Container::Iterator, typename Container::ValueType>
+    void stable_sort(Container& c, Comp comp = Comp()) {
+        Sort<true>(c.begin(), c.end(), comp);
+    }
+
+private:
+    // element i of a range that isn't contiguous, through its iterator
+    template <typename It>
+    struct Indexed {
+        It first;
+
+        decltype(auto) operator[](size_t i) const {
+            return *(first + typename It::ItDiff(i));
+        }
+    };
+
+    template <typename It>
+    static auto Data(It first, It last) {
+        if constexpr (IsContiguousIterator<It, typename It::ValueType>) {
+            return first != last ? &*first : nullptr;
+        } else {
+            return Indexed<It>{first};
+        }
+    }
+
+    size_t Chunks(size_t n) const noexcept {
+        return n == 0 ? 0 : (n + grain - 1) / grain;
+    }
+
+    static size_t Bound(size_t n, size_t chunks, size_t k) noexcept {
+        return n / chunks * k + n % chunks * k / chunks;
+    }
+
+    template <typename F>
+    void ForChunks(size_t n, F f) {
+        size_t chunks = Chunks(n);
+        pool.run(chunks, [&](size_t k) {
+            f(Bound(n, chunks, k), Bound(n, chunks, k + 1));
+        });
+    }
+
+    template <bool Stable, typename It, typename Comp>
+    void Sort(It first, It last, Comp comp) {
+        using T = typename It::ValueType;
+        size_t n = last - first;
+        if (n < 2) return;
+        if constexpr (IsContiguousIterator<It, T>) {
+            SortRuns<Stable>(&*first, n, comp);
+        } else {
+            // the merge passes need a contiguous buffer anyway
+            Array<T> copy(n);
+            T* buf = &*copy.begin();
+            auto range = Data(first, last);
+            ForChunks(n, [&](size_t from, size_t to) {
+                for (size_t i = from; i < to; ++i) buf[i] = std::move(range[i]);
+            });
+            SortRuns<Stable>(buf, n, comp);
+            ForChunks(n, [&](size_t from, size_t to) {
+                for (size_t i = from; i < to; ++i) range[i] = std::move(buf[i]);
+            });
+        }
+    }
+
+    // sorts one chunk per thread, then merges neighbouring runs pairwise; every merge
+    // is cut into independent pieces (split points found by binary search) so that
+    // the last passes keep all threads busy as well
+    template <bool Stable, typename T, typename Comp>
+    void SortRuns(T* data, size_t n, Comp comp) {
+        size_t runs = std::min(pool.size(), Chunks(n));
+        if (runs < 2) {
+            if constexpr (Stable) std::stable_sort(data, data + n, comp);
+            else std::sort(data, data + n, comp);
+            return;
+        }
+        pool.run(runs, [&](size_t k) {
+            T* from = data + Bound(n, runs, k), *to = data + Bound(n, runs, k + 1);
+            if constexpr (Stable) std::stable_sort(from, to, comp);
+            else std::sort(from, to, comp);
+        });
+        Array<T> buffer(n);
+        T* src = data, *dst = &*buffer.begin();
+        for (size_t width = 1; width < runs; width *= 2) {
+            size_t pairs = (runs + 2*width - 1) / (2*width);
+            size_t pieces = std::max<size_t>(1, pool.size() / pairs);
+            pool.run(pairs*pieces, [&](size_t task) {
+                size_t p = task / pieces, piece = task % pieces;
+                size_t lo = Bound(n, runs, 2*p*width);
+                size_t mid = Bound(n, runs, std::min(runs, 2*p*width + width));
+                size_t hi = Bound(n, runs, std::min(runs, 2*p*width + 2*width));
+                // piece takes a slice of the left run and the right elements that sort before its end
+                size_t a1 = lo + (mid - lo) * piece / pieces, a2 = lo + (mid - lo) * (piece + 1) / pieces;
+                size_t b1 = (piece == 0 ? mid : std::lower_bound(src + mid, src + hi, src[a1], comp) - src);
+                size_t b2 = (piece + 1 == pieces ? hi : std::lower_bound(src + mid, src + hi, src[a2], comp) - src);
+                std::merge(std::make_move_iterator(src + a1), std::make_move_iterator(src + a2),
+                           std::make_move_iterator(src + b1), std::make_move_iterator(src + b2),
+                           dst + a1 + (b1 - mid), comp);
+            });
+            std::swap(src, dst);
+        }
+        if (src != data) {
+            ForChunks(n, [&](size_t from, size_t to) {
+                std::move(src + from, src + to, data + from);
+            });
+        }
+    }
+
+    ThreadPool pool;
+    size_t grain;
+};
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "altraits.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <concepts>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+// Maps a key to unsigned bits whose unsigned order is the key's order: unsigned
+// integers as they are, signed ones with the sign bit flipped, IEEE floats with the
+// sign bit flipped for positives and every bit flipped for negatives (NaNs sort
+// past the infinities of their sign).
+template <typename K>
+struct RadixKey;
+
+template <std::unsigned_integral K> requires (!std::same_as<K, bool>)
+struct RadixKey<K> {
+    using Bits = K;
+    static Bits bits(K key) noexcept {
+        return key;
+    }
+};
+
+template <std::signed_integral K>
+struct RadixKey<K> {
+    using Bits = std::make_unsigned_t<K>;
+    static Bits bits(K key) noexcept {
+        return static_cast<Bits>(key) ^ (Bits(1) << (sizeof(Bits)*8 - 1));
+    }
+};
+
+template <std::floating_point K> requires (sizeof(K) == 4 || sizeof(K) == 8)
+struct RadixKey<K> {
+    using Bits = std::conditional_t<sizeof(K) == 4, uint32_t, uint64_t>;
+    static Bits bits(K key) noexcept {
+        Bits b = std::bit_cast<Bits>(key);
+        Bits sign = Bits(1) << (sizeof(Bits)*8 - 1);
+        return b ^ ((b & sign) ? ~Bits(0) : sign);
+    }
+};
+
+template <typename K>
+concept RadixSortable = requires (K key) {
+    {RadixKey<K>::bits(key)} -> std::unsigned_integral;
+};
+
+template <typename F, typename T>
+concept RadixKeyExtractor = std::invocable<const F&, const T&>
+    && RadixSortable<std::remove_cvref_t<std::invoke_result_t<const F&, const T&>>>;
+
+struct RadixIdentity {
+    template <typename T>
+    const T& operator()(const T& val) const noexcept {
+        return val;
+    }
+};
+
+// Radix sorts over contiguous ranges, one byte of the key per pass. lsd() is stable
+// and moves the elements through a scratch buffer taken from the given allocator;
+// msd() permutes in place (American flag sort) and needs no extra memory but isn't stable.
+// Passes over a byte that is the same in every key are skipped.
+template <typename T, RadixKeyExtractor<T> KeyFn = RadixIdentity>
+class RadixKernels {
+    using Key = std::remove_cvref_t<std::invoke_result_t<const KeyFn&, const T&>>;
+    using Bits = typename RadixKey<Key>::Bits;
+
+    static constexpr size_t radix = 256;
+    static constexpr size_t passes = sizeof(Bits);
+    static constexpr size_t small_size = 64;
+
+public:
+    template <TAllocator Alloc>
+    static void lsd(T* data, size_t n, const KeyFn& key, Alloc& alloc) {
+        using AllocTraits = AllocatorTraits<T, Alloc>;
+        if (n <= small_size) {
+            InsertionSort(data, n, key);
+            return;
+        }
+        T* scratch = AllocTraits::allocate(alloc, n);
+        if constexpr (!std::is_trivially_copyable_v<T>) {
+            for (size_t i = 0; i < n; ++i) AllocTraits::construct(alloc, scratch + i);
+        }
+        size_t counts[passes][radix] = {};
+        for (size_t i = 0; i < n; ++i) {
+            Bits b = KeyBits(data[i], key);
+            for (size_t p = 0; p < passes; ++p) ++counts[p][Digit(b, p*8)];
+        }
+        T* src = data, *dst = scratch;
+        for (size_t p = 0; p < passes; ++p) {
+            size_t* count = counts[p];
+            if (count[Digit(KeyBits(src[0], key), p*8)] == n) continue;
+            size_t offset[radix];
+            for (size_t d = 0, sum = 0; d < radix; ++d) {
+                offset[d] = sum;
+                sum += count[d];
+            }
+            for (size_t i = 0; i < n; ++i) {
+                dst[offset[Digit(KeyBits(src[i], key), p*8)]++] = std::move(src[i]);
+            }
+            std::swap(src, dst);
+        }
+        if (src != data) {
+            for (size_t i = 0; i < n; ++i) data[i] = std::move(src[i]);
+        }
+        if constexpr (!std::is_trivially_copyable_v<T>) {
+            for (size_t i = 0; i < n; ++i) AllocTraits::destroy(alloc, scratch + i);
+        }
+        AllocTraits::deallocate(alloc, scratch, n);
+    }
+
+    static void msd(T* data, size_t n, const KeyFn& key) {
+        MSD(data, n, key, (passes - 1)*8);
+    }
+
+private:
+    static Bits KeyBits(const T& val, const KeyFn& key) noexcept {
+        return RadixKey<Key>::bits(std::invoke(key, val));
+    }
+
+    static size_t Digit(Bits b, size_t shift) noexcept {
+        return static_cast<size_t>(b >> shift) & (radix - 1);
+    }
+
+    static void InsertionSort(T* data, size_t n, const KeyFn& key) {
+        for (size_t i = 1; i < n; ++i) {
+            Bits b = KeyBits(data[i], key);
+            size_t j = i;
+            if (!(b < KeyBits(data[j - 1], key))) continue;
+            T tmp = std::move(data[i]);
+            for (; j > 0 && b < KeyBits(data[j - 1], key); --j) {
+                data[j] = std::move(data[j - 1]);
+            }
+            data[j] = std::move(tmp);
+        }
+    }
+
+    static void MSD(T* data, size_t n, const KeyFn& key, size_t shift) {
+        if (n <= small_size) {
+            InsertionSort(data, n, key);
+            return;
+        }
+        size_t count[radix], next[radix], end[radix];
+        while (true) {
+            std::fill(count, count + radix, 0);
+            for (size_t i = 0; i < n; ++i) ++count[Digit(KeyBits(data[i], key), shift)];
+            if (count[Digit(KeyBits(data[0], key), shift)] != n) break;
+            if (shift == 0) return;
+            shift -= 8;
+        }
+        for (size_t d = 0, sum = 0; d < radix; ++d) {
+            next[d] = sum;
+            sum += count[d];
+            end[d] = sum;
+        }
+        // each swap puts one element into its bucket for good
+        for (size_t d = 0; d < radix; ++d) {
+            while (next[d] < end[d]) {
+                size_t to = Digit(KeyBits(data[next[d]], key), shift);
+                if (to == d) {
+                    ++next[d];
+                } else {
+                    std::swap(data[next[d]], data[next[to]++]);
+                }
+            }
+        }
+        if (shift == 0) return;
+        for (size_t d = 0, from = 0; d < radix; from = end[d++]) {
+            if (end[d] - from > 1) MSD(data + from, end[d] - from, key, shift - 8);
+        }
+    }
+};
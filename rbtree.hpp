@@ -1,28 +1,21 @@
+#pragma once
+
 #include <concepts>
 #include <initializer_list>
 #include "list.hpp"
+#include "array.hpp"
+#include <bit>
+#include "compare.hpp"
 
 enum Color {
     Red, Black
 };
 
-template <typename T, typename V>
-concept Comparator = requires (T a, V v) {
-    {a(v, v)} -> std::same_as<bool>;
-};
-
 template <typename VtoK, typename K, typename V>
 concept Converter = requires (VtoK conv, V val) {
     {conv(val)} -> std::same_as<const K&>;
 };
 
-template <typename V>
-struct Less {
-    bool operator()(const V& v1, const V& v2) const noexcept {
-        return v1 < v2;
-    }
-};
-
 template <typename V>
 struct RBNode {
     RBNode *parent, *left, *right;
@@ -55,29 +48,23 @@ public:
             TAllocator AlType>
     friend class RBTree;
 
-    RBtreeIterator(const Base& other) : RBtreeIterator(static_cast<const RBtreeIterator&>(other)) {}
-    RBtreeIterator(const ForwardIterator<ValueType>& other) : RBtreeIterator(static_cast<const RBtreeIterator&>(other)) {}
-
-    Reference operator*() const override {
+    Reference operator*() const {
         return node->val;
     }
-    Pointer operator->() const override {
+    Pointer operator->() const {
         return &(node->val);
     }
 
-    ForwardIterator<ValueType>& operator++() override {
+    RBtreeIterator& operator++() {
         if (node->right != nullptr) {
             node = node->right;
             while (node->left) node = node->left;
             return *this;
         } else {
             while (node->parent) {
-                if (node->parent->right == node) {
-                    node = node->parent;
-                } else {
-                    node = node->parent;
-                    if (node->right) return *this;
-                }
+                bool fromleft = (node->parent->left == node);
+                node = node->parent;
+                if (fromleft) return *this;
             }
             throw IteratorOutOfBounds();
         }
@@ -88,19 +75,16 @@ public:
         return it;
     }
 
-    Base& operator--() override {
+    RBtreeIterator& operator--() {
         if (node->left != nullptr) {
             node = node->left;
             while (node->right) node = node->right;
             return *this;
         } else {
             while (node->parent) {
-                if (node->parent->left == node) {
-                    node = node->parent;
-                } else {
-                    node = node->parent;
-                    if (node->left) return *this;
-                }
+                bool fromright = (node->parent->right == node);
+                node = node->parent;
+                if (fromright) return *this;
             }
             throw IteratorOutOfBounds();
         }
@@ -111,11 +95,11 @@ public:
         return it;
     }
 
-    bool operator==(const ForwardIterator<ValueType>& other) const noexcept override {
-        return node == static_cast<const RBtreeIterator&>(other).node;
+    bool operator==(const RBtreeIterator& other) const noexcept {
+        return node == other.node;
     }
-    bool operator!=(const ForwardIterator<ValueType>& other) const noexcept override {
-        return node != static_cast<const RBtreeIterator&>(other).node;
+    bool operator!=(const RBtreeIterator& other) const noexcept {
+        return node != other.node;
     }
 private:
     RBtreeIterator(Node* node) : node(node) {}
@@ -142,29 +126,23 @@ public:
         TAllocator AlType>
     friend class RBTree;
 
-    constRBtreeIterator(const Base& other) : constRBtreeIterator(static_cast<const constRBtreeIterator&>(other)) {}
-    constRBtreeIterator(const ConstForwardIterator<ValueType>& other) : constRBtreeIterator(static_cast<const constRBtreeIterator&>(other)) {}
-
-    ConstReference operator*() const override {
+    ConstReference operator*() const {
         return node->val;
     }
-    ConstPointer operator->() const override {
+    ConstPointer operator->() const {
         return &(node->val);
     }
 
-    ConstForwardIterator<ValueType>& operator++() override {
+    constRBtreeIterator& operator++() {
         if (node->right != nullptr) {
             node = node->right;
             while (node->left) node = node->left;
             return *this;
         } else {
             while (node->parent) {
-                if (node->parent->right == node) {
-                    node = node->parent;
-                } else {
-                    node = node->parent;
-                    if (node->right) return *this;
-                }
+                bool fromleft = (node->parent->left == node);
+                node = node->parent;
+                if (fromleft) return *this;
             }
             throw IteratorOutOfBounds();
         }
@@ -175,19 +153,16 @@ public:
         return it;
     }
 
-    Base& operator--() override {
+    constRBtreeIterator& operator--() {
         if (node->left != nullptr) {
             node = node->left;
             while (node->right) node = node->right;
             return *this;
         } else {
             while (node->parent) {
-                if (node->parent->left == node) {
-                    node = node->parent;
-                } else {
-                    node = node->parent;
-                    if (node->left) return *this;
-                }
+                bool fromright = (node->parent->right == node);
+                node = node->parent;
+                if (fromright) return *this;
             }
             throw IteratorOutOfBounds();
         }
@@ -198,11 +173,11 @@ public:
         return it;
     }
 
-    bool operator==(const ConstForwardIterator<ValueType>& other) const noexcept override {
-        return node == static_cast<const constRBtreeIterator&>(other).node;
+    bool operator==(const constRBtreeIterator& other) const noexcept {
+        return node == other.node;
     }
-    bool operator!=(const ConstForwardIterator<ValueType>& other) const noexcept override {
-        return node != static_cast<const constRBtreeIterator&>(other).node;
+    bool operator!=(const constRBtreeIterator& other) const noexcept {
+        return node != other.node;
     }
 private:
     constRBtreeIterator(Node* node) : node(node) {}
@@ -514,11 +489,37 @@ private:
         }
     }
 
+    // links vals[from, to) into a balanced subtree; nodes below the last complete level are red
+    Node* Build(Pointer vals, SizeType from, SizeType to, Node* parent, SizeType depth, SizeType complete) {
+        if (from == to) return nullptr;
+        SizeType mid = from + (to - from - 1) / 2;
+        Node* node = NodeAllocTraits::allocate(nalloc, 1);
+        NodeAllocTraits::construct(nalloc, node, parent, nullptr, nullptr, depth < complete ? Black : Red, std::move(vals[mid]));
+        ++_size;
+        node->left = Build(vals, from, mid, node, depth + 1, complete);
+        node->right = Build(vals, mid + 1, to, node, depth + 1, complete);
+        return node;
+    }
+
+    // fills the empty tree from n sorted values in O(n)
+    void BuildSorted(Pointer vals, SizeType n) {
+        if (n == 0) return;
+        root = Build(vals, 0, n, nullptr, 0, std::bit_width(n + 1) - 1);
+        Node* last = root;
+        while (last->right) last = last->right;
+        last->right = fictional;
+        fictional->parent = last;
+        fictional->left = fictional->right = nullptr;
+    }
+
     void Clear (Node* node) {
         if (node->left) Clear(node->left);
         if (node->right) Clear(node->right);
-        NodeAllocTraits::destroy(nalloc, node);
-        --_size;
+        // the fictional node holds no value
+        if (node != fictional) {
+            NodeAllocTraits::destroy(nalloc, node);
+            --_size;
+        }
         NodeAllocTraits::deallocate(nalloc, node, 1);
     }
 public:
@@ -563,16 +564,25 @@ public:
             q.pop_front();
         }
     }
-    RBTree(RBTree&& other) : root(other.root), _size(other._size), fictional(other.fictional), alloc(other.alloc), nalloc(other.nalloc) {}
+    RBTree(RBTree&& other) : RBTree() {
+        // nodes belong to the node allocator, so it has to travel with them
+        std::swap(root, other.root);
+        std::swap(fictional, other.fictional);
+        std::swap(_size, other._size);
+        std::swap(nalloc, other.nalloc);
+    }
     template <IsForwardIterator<ValueType> Iter>
     RBTree(Iter first, Iter last) : RBTree() {
         while (first != last) {
             Insert(*first);
+            ++first;
         }
     }
 
     ~RBTree() {
-        Clear(root);
+        if constexpr (!NodeAllocTraits::skip_teardown) {
+            Clear(root);
+        }
     }
     SizeType size() const noexcept {
         return _size;
@@ -661,7 +671,11 @@ public:
         }
     }
     void clear() {
-        Clear(root);
+        if constexpr (NodeAllocTraits::skip_teardown) {
+            _size = 0;
+        } else {
+            Clear(root);
+        }
         root = fictional = NodeAllocTraits::allocate(nalloc, 1);
         root->parent = root->right = root->left = nullptr;
         root->color = Black;
@@ -671,6 +685,29 @@ public:
         ValueType val(std::forward<Args>(args)...);
         Insert(std::move(val));
     }
+
+    // binary snapshot (see snapshot.hpp) of the values in order, so load() checks the
+    // order and rebuilds the tree in O(n) instead of inserting the values one by one
+    void save(std::ostream& out) const requires Serializable<ValueType> && std::default_initializable<ValueType> {
+        SnapshotHeader::write(out, SnapshotKind::Tree, snapshot_value_size<ValueType>, _size);
+        SnapshotBuffer<ValueType>::write(out, cbegin(), cend());
+    }
+
+    void load(std::istream& in) requires Serializable<ValueType> && std::default_initializable<ValueType> {
+        uint64_t n = SnapshotHeader::read(in, SnapshotKind::Tree, snapshot_value_size<ValueType>);
+        Array<ValueType> vals;
+        vals.reserve(snapshot_reserve(in, n, snapshot_value_size<ValueType>));
+        SnapshotBuffer<ValueType>::read(in, n, [&vals](ValueType&& val) {
+            vals.append(std::move(val));
+        });
+        Pointer data = (n ? &*vals.begin() : nullptr);
+        for (SizeType i = 1; i < n; ++i) {
+            bool ordered = (IsMulti ? !comp(conv(data[i]), conv(data[i - 1])) : comp(conv(data[i - 1]), conv(data[i])));
+            if (!ordered) throw SnapshotError();
+        }
+        clear();
+        BuildSorted(data, n);
+    }
     void erase(const KeyType& key) {
         Node* node = Find(key);
         while (node && node != fictional && !comp(key, conv(node->val)) && !comp(conv(node->val), key)) {
@@ -683,7 +720,7 @@ public:
         Erase(node);
     }
 
-    std::enable_if_t<!std::same_as<KeyType, ValueType>> erase(ConstIterator iterator) {
+    void erase(ConstIterator iterator) requires (!std::same_as<KeyType, ValueType>) {
         Node* node = iterator.node;
         Erase(node);
     }
@@ -694,7 +731,7 @@ public:
             Erase(node);
         }
     }
-    std::enable_if_t<!std::same_as<KeyType, ValueType>> erase(ConstIterator first, ConstIterator last) {
+    void erase(ConstIterator first, ConstIterator last) requires (!std::same_as<KeyType, ValueType>) {
         while (first.node != last.node) {
             Node* node = first.node;
             ++first;
@@ -0,0 +1,525 @@
+#pragma once
+
+#include "array.hpp"
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
+template <typename ValueType>
+class ringIterator : public RandomAccessIterator<ValueType> {
+public:
+    using Base              = RandomAccessIterator<ValueType>;
+    using Pointer           = typename Base::Pointer;
+    using ConstPointer      = typename Base::ConstPointer;
+    using Reference         = typename Base::Reference;
+    using ConstReference    = typename Base::ConstReference;
+    using ItDiff            = typename Base::ItDiff;
+    using SizeType          = typename Base::SizeType;
+
+    template <std::default_initializable VT, TAllocator AllocatorType>
+    friend class RingBuffer;
+
+private:
+    ringIterator(const Pointer& arr, const SizeType& head, const SizeType& mask, const SizeType& size, SizeType pos)
+        : arr(arr), head(head), mask(mask), size(size), pos(pos) {}
+
+public:
+
+    bool operator==(const ringIterator& it) const noexcept {
+        if constexpr (checked_access) {
+            return &head == &it.head && pos == it.pos;
+        } else {
+            return pos == it.pos;
+        }
+    }
+
+    bool operator!=(const ringIterator& it) const noexcept {
+        return !(*this == it);
+    }
+
+    bool operator>(const ringIterator& it) const {
+        Check(it);
+        return pos > it.pos;
+    }
+
+    bool operator<(const ringIterator& it) const {
+        Check(it);
+        return pos < it.pos;
+    }
+
+    bool operator>=(const ringIterator& it) const {
+        Check(it);
+        return pos >= it.pos;
+    }
+
+    bool operator<=(const ringIterator& it) const {
+        Check(it);
+        return pos <= it.pos;
+    }
+
+    Reference operator*() const {
+        if constexpr (checked_access) {
+            if (pos >= size) throw UndereferencableIterator();
+        }
+        return arr[(head + pos) & mask];
+    }
+
+    Pointer operator->() const {
+        return &**this;
+    }
+
+    ringIterator& operator++() {
+        if constexpr (checked_access) {
+            if (pos >= size) throw IteratorOutOfBounds();
+        }
+        ++pos;
+        return *this;
+    }
+
+    ringIterator operator++(int) {
+        ringIterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    ringIterator& operator--() {
+        if constexpr (checked_access) {
+            if (pos == 0) throw IteratorOutOfBounds();
+        }
+        --pos;
+        return *this;
+    }
+
+    ringIterator operator--(int) {
+        ringIterator it = *this;
+        --*this;
+        return it;
+    }
+
+    ringIterator& operator+=(ItDiff offset) {
+        if constexpr (checked_access) {
+            if (pos + offset > size) throw IteratorOutOfBounds();
+        }
+        pos += offset;
+        return *this;
+    }
+
+    ringIterator& operator-=(ItDiff offset) {
+        return *this += -offset;
+    }
+
+    ringIterator operator+ (ItDiff offset) const {
+        ringIterator it = *this;
+        return it += offset;
+    }
+
+    ringIterator operator- (ItDiff offset) const {
+        ringIterator it = *this;
+        return it += -offset;
+    }
+
+    ItDiff operator- (const ringIterator& it) const {
+        Check(it);
+        return ItDiff(pos) - it.pos;
+    }
+
+private:
+    void Check(const ringIterator& it) const {
+        if constexpr (checked_access) {
+            if (&head != &it.head) throw NotComparableIterators();
+        }
+    }
+
+    const Pointer& arr;
+    const SizeType& head;
+    const SizeType& mask;
+    const SizeType& size;
+    SizeType pos;
+};
+
+template <typename ValueType>
+class constRingIterator : public ConstRandomAccessIterator<ValueType> {
+public:
+    using Base              = ConstRandomAccessIterator<ValueType>;
+    using Pointer           = typename Base::Pointer;
+    using ConstPointer      = typename Base::ConstPointer;
+    using Reference         = typename Base::Reference;
+    using ConstReference    = typename Base::ConstReference;
+    using ItDiff            = typename Base::ItDiff;
+    using SizeType          = typename Base::SizeType;
+
+    template <std::default_initializable VT, TAllocator AllocatorType>
+    friend class RingBuffer;
+
+private:
+    constRingIterator(const Pointer& arr, const SizeType& head, const SizeType& mask, const SizeType& size, SizeType pos)
+        : arr(arr), head(head), mask(mask), size(size), pos(pos) {}
+
+public:
+
+    bool operator==(const constRingIterator& it) const noexcept {
+        if constexpr (checked_access) {
+            return &head == &it.head && pos == it.pos;
+        } else {
+            return pos == it.pos;
+        }
+    }
+
+    bool operator!=(const constRingIterator& it) const noexcept {
+        return !(*this == it);
+    }
+
+    bool operator>(const constRingIterator& it) const {
+        Check(it);
+        return pos > it.pos;
+    }
+
+    bool operator<(const constRingIterator& it) const {
+        Check(it);
+        return pos < it.pos;
+    }
+
+    bool operator>=(const constRingIterator& it) const {
+        Check(it);
+        return pos >= it.pos;
+    }
+
+    bool operator<=(const constRingIterator& it) const {
+        Check(it);
+        return pos <= it.pos;
+    }
+
+    ConstReference operator*() const {
+        if constexpr (checked_access) {
+            if (pos >= size) throw UndereferencableIterator();
+        }
+        return arr[(head + pos) & mask];
+    }
+
+    ConstPointer operator->() const {
+        return &**this;
+    }
+
+    constRingIterator& operator++() {
+        if constexpr (checked_access) {
+            if (pos >= size) throw IteratorOutOfBounds();
+        }
+        ++pos;
+        return *this;
+    }
+
+    constRingIterator operator++(int) {
+        constRingIterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    constRingIterator& operator--() {
+        if constexpr (checked_access) {
+            if (pos == 0) throw IteratorOutOfBounds();
+        }
+        --pos;
+        return *this;
+    }
+
+    constRingIterator operator--(int) {
+        constRingIterator it = *this;
+        --*this;
+        return it;
+    }
+
+    constRingIterator& operator+=(ItDiff offset) {
+        if constexpr (checked_access) {
+            if (pos + offset > size) throw IteratorOutOfBounds();
+        }
+        pos += offset;
+        return *this;
+    }
+
+    constRingIterator& operator-=(ItDiff offset) {
+        return *this += -offset;
+    }
+
+    constRingIterator operator+ (ItDiff offset) const {
+        constRingIterator it = *this;
+        return it += offset;
+    }
+
+    constRingIterator operator- (ItDiff offset) const {
+        constRingIterator it = *this;
+        return it += -offset;
+    }
+
+    ItDiff operator- (const constRingIterator& it) const {
+        Check(it);
+        return ItDiff(pos) - it.pos;
+    }
+
+private:
+    void Check(const constRingIterator& it) const {
+        if constexpr (checked_access) {
+            if (&head != &it.head) throw NotComparableIterators();
+        }
+    }
+
+    const Pointer& arr;
+    const SizeType& head;
+    const SizeType& mask;
+    const SizeType& size;
+    SizeType pos;
+};
+
+// Circular buffer of fixed capacity, rounded up to a power of two so that a position
+// is (head + i) & mask rather than a division. Pushing and popping at either end is
+// O(1) and never allocates; pushing into a full buffer throws FullCollection. Batch
+// push_back/pop_front copy a span in at most two runs (memcpy for trivially copyable
+// types), and first_slice()/second_slice() view the filled storage as the (up to two)
+// contiguous Slices it occupies, front to back.
+template <std::default_initializable VType, TAllocator AlType = Allocator<VType>>
+class RingBuffer {
+
+public:
+    using ValueType             = VType;
+    using Pointer               = ValueType*;
+    using Reference             = ValueType&;
+    using ConstPointer          = const ValueType*;
+    using ConstReference        = const ValueType&;
+    using AllocatorType         = AlType;
+    using Iterator              = ringIterator<ValueType>;
+    using ConstIterator         = constRingIterator<ValueType>;
+    using SliceType             = Slice<ValueType>;
+    using SizeType              = typename Iterator::SizeType;
+    using ItDiff                = typename Iterator::ItDiff;
+
+private:
+    using AllocTraits       = AllocatorTraits<ValueType, AllocatorType>;
+
+    static constexpr bool raw_copy = std::is_trivially_copyable_v<ValueType>;
+
+public:
+
+    explicit RingBuffer(SizeType capacity) : mask(std::bit_ceil(capacity) - 1), head(0), _size(0), alloc() {
+        arr = AllocTraits::allocate(alloc, mask + 1);
+    }
+
+    RingBuffer(const RingBuffer& other) : RingBuffer(other.capacity()) {
+        for (auto it = other.cbegin(); it != other.cend(); ++it) {
+            emplace_back(*it);
+        }
+    }
+
+    // the moved-from buffer is left empty with capacity 1, as Array is left with its initial capacity
+    RingBuffer(RingBuffer&& other) : RingBuffer(1) {
+        Swap(other);
+    }
+
+    ~RingBuffer() {
+        clear();
+        AllocTraits::deallocate(alloc, arr, mask + 1);
+    }
+
+    void operator=(const RingBuffer& other) {
+        if (this == &other) return;
+        RingBuffer copy(other);
+        Swap(copy);
+    }
+
+    void operator=(RingBuffer&& other) {
+        RingBuffer moved(std::move(other));
+        Swap(moved);
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(arr, head, mask, _size, 0);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return ConstIterator(arr, head, mask, _size, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(arr, head, mask, _size, _size);
+    }
+
+    ConstIterator cend() const noexcept {
+        return ConstIterator(arr, head, mask, _size, _size);
+    }
+
+    SizeType size() const noexcept {
+        return _size;
+    }
+
+    SizeType capacity() const noexcept {
+        return mask + 1;
+    }
+
+    bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    bool full() const noexcept {
+        return _size == mask + 1;
+    }
+
+    // index taken modulo size, negative indices count from the end
+    Reference at(ItDiff ind) noexcept {
+        if (ind >= 0) {
+            return Element(ind % _size);
+        } else {
+            return Element((_size + ind % ItDiff(_size)) % _size);
+        }
+    }
+
+    // wraps like at() in checked mode, plain offset in unchecked mode
+    Reference operator[](ItDiff ind) noexcept {
+        if constexpr (checked_access) {
+            return at(ind);
+        } else {
+            return Element(ind);
+        }
+    }
+
+    ConstReference operator[](ItDiff ind) const noexcept {
+        return const_cast<RingBuffer&>(*this)[ind];
+    }
+
+    Reference front() {
+        if (_size == 0) throw UndereferencableIterator();
+        return Element(0);
+    }
+
+    Reference back() {
+        if (_size == 0) throw UndereferencableIterator();
+        return Element(_size - 1);
+    }
+
+    template <typename... Args>
+    Reference emplace_back(Args&&... args) {
+        if (full()) throw FullCollection();
+        AllocTraits::construct(alloc, &Element(_size), std::forward<Args>(args)...);
+        return Element(_size++);
+    }
+
+    template <typename... Args>
+    Reference emplace_front(Args&&... args) {
+        if (full()) throw FullCollection();
+        AllocTraits::construct(alloc, arr + ((head - 1) & mask), std::forward<Args>(args)...);
+        head = (head - 1) & mask;
+        ++_size;
+        return Element(0);
+    }
+
+    void push_back(const ValueType& val) {
+        emplace_back(val);
+    }
+
+    void push_back(ValueType&& val) {
+        emplace_back(std::move(val));
+    }
+
+    void push_front(const ValueType& val) {
+        emplace_front(val);
+    }
+
+    void push_front(ValueType&& val) {
+        emplace_front(std::move(val));
+    }
+
+    // copies n elements to the back; throws FullCollection without pushing any if they don't fit
+    void push_back(ConstPointer data, SizeType n) {
+        if (n > capacity() - _size) throw FullCollection();
+        SizeType tail = (head + _size) & mask;
+        SizeType first = std::min(n, capacity() - tail);
+        if constexpr (raw_copy) {
+            std::memcpy(arr + tail, data, first*sizeof(ValueType));
+            std::memcpy(arr, data + first, (n - first)*sizeof(ValueType));
+            _size += n;
+        } else {
+            for (SizeType i = 0; i < n; ++i) emplace_back(data[i]);
+        }
+    }
+
+    void pop_back() {
+        if (_size == 0) throw NothingToErase();
+        AllocTraits::destroy(alloc, &Element(--_size));
+    }
+
+    void pop_front() {
+        if (_size == 0) throw NothingToErase();
+        AllocTraits::destroy(alloc, arr + head);
+        head = (head + 1) & mask;
+        --_size;
+    }
+
+    // moves up to n elements from the front into out, the number moved
+    SizeType pop_front(Pointer out, SizeType n) {
+        n = std::min(n, _size);
+        SizeType first = std::min(n, capacity() - head);
+        if constexpr (raw_copy) {
+            std::memcpy(out, arr + head, first*sizeof(ValueType));
+            std::memcpy(out + first, arr, (n - first)*sizeof(ValueType));
+            head = (head + n) & mask;
+            _size -= n;
+        } else {
+            for (SizeType i = 0; i < n; ++i) {
+                out[i] = std::move(arr[head]);
+                pop_front();
+            }
+        }
+        return n;
+    }
+
+    // drops n elements from the front
+    void pop_front(SizeType n) {
+        if (n > _size) throw NothingToErase();
+        if constexpr (raw_copy) {
+            head = (head + n) & mask;
+            _size -= n;
+        } else {
+            for (; n != 0; --n) pop_front();
+        }
+    }
+
+    // drops n elements from the back
+    void pop_back(SizeType n) {
+        if (n > _size) throw NothingToErase();
+        if constexpr (raw_copy) {
+            _size -= n;
+        } else {
+            for (; n != 0; --n) pop_back();
+        }
+    }
+
+    void clear() {
+        pop_back(_size);
+        head = 0;
+    }
+
+    // the filled storage from the front up to the end of the buffer or the back
+    SliceType first_slice() noexcept {
+        return SliceType(arr + head, std::min(_size, capacity() - head));
+    }
+
+    // the filled storage wrapped around to the start of the buffer, empty if there is none
+    SliceType second_slice() noexcept {
+        SizeType first = std::min(_size, capacity() - head);
+        return SliceType(arr, _size - first);
+    }
+
+private:
+    Reference Element(SizeType ind) const noexcept {
+        return arr[(head + ind) & mask];
+    }
+
+    void Swap(RingBuffer& other) {
+        std::swap(arr, other.arr);
+        std::swap(mask, other.mask);
+        std::swap(head, other.head);
+        std::swap(_size, other._size);
+        std::swap(alloc, other.alloc);
+    }
+
+    Pointer arr;
+    SizeType mask, head, _size;
+    AllocatorType alloc;
+};
@@ -0,0 +1,528 @@
+#pragma once
+
+#include "allocator.hpp"
+#include "altraits.hpp"
+#include "iterators.hpp"
+#include "exceptions.hpp"
+#include <algorithm>
+#include <bit>
+#include <initializer_list>
+
+template <std::default_initializable VType, TAllocator AlType, size_t ChunkSize> requires (std::has_single_bit(ChunkSize))
+class SegmentedArray;
+
+// about a page worth of elements per chunk, at least 16
+template <typename T>
+inline constexpr size_t default_chunk_size = std::bit_floor(std::max<size_t>(16, 4096 / sizeof(T)));
+
+template <typename ValueType, size_t ChunkSize>
+class segmentedIterator : public RandomAccessIterator<ValueType> {
+public:
+    using Base              = RandomAccessIterator<ValueType>;
+    using Pointer           = typename Base::Pointer;
+    using ConstPointer      = typename Base::ConstPointer;
+    using Reference         = typename Base::Reference;
+    using ConstReference    = typename Base::ConstReference;
+    using ItDiff            = typename Base::ItDiff;
+    using SizeType          = typename Base::SizeType;
+
+    template <std::default_initializable VT, TAllocator AllocatorType, size_t CS> requires (std::has_single_bit(CS))
+    friend class SegmentedArray;
+
+private:
+    segmentedIterator(Pointer* const& map, const SizeType& head, const SizeType& size, SizeType pos) : map(map), head(head), size(size), pos(pos) {}
+
+public:
+
+    bool operator==(const segmentedIterator& it) const noexcept {
+        if constexpr (checked_access) {
+            return &head == &it.head && pos == it.pos;
+        } else {
+            return pos == it.pos;
+        }
+    }
+
+    bool operator!=(const segmentedIterator& it) const noexcept {
+        return !(*this == it);
+    }
+
+    bool operator>(const segmentedIterator& it) const {
+        Check(it);
+        return pos > it.pos;
+    }
+
+    bool operator<(const segmentedIterator& it) const {
+        Check(it);
+        return pos < it.pos;
+    }
+
+    bool operator>=(const segmentedIterator& it) const {
+        Check(it);
+        return pos >= it.pos;
+    }
+
+    bool operator<=(const segmentedIterator& it) const {
+        Check(it);
+        return pos <= it.pos;
+    }
+
+    Reference operator*() const {
+        if constexpr (checked_access) {
+            if (pos >= size) throw UndereferencableIterator();
+        }
+        SizeType ind = head + pos;
+        return map[ind / ChunkSize][ind % ChunkSize];
+    }
+
+    Pointer operator->() const {
+        return &**this;
+    }
+
+    segmentedIterator& operator++() {
+        if constexpr (checked_access) {
+            if (pos >= size) throw IteratorOutOfBounds();
+        }
+        ++pos;
+        return *this;
+    }
+
+    segmentedIterator operator++(int) {
+        segmentedIterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    segmentedIterator& operator--() {
+        if constexpr (checked_access) {
+            if (pos == 0) throw IteratorOutOfBounds();
+        }
+        --pos;
+        return *this;
+    }
+
+    segmentedIterator operator--(int) {
+        segmentedIterator it = *this;
+        --*this;
+        return it;
+    }
+
+    segmentedIterator& operator+=(ItDiff offset) {
+        if constexpr (checked_access) {
+            if (pos + offset > size) throw IteratorOutOfBounds();
+        }
+        pos += offset;
+        return *this;
+    }
+
+    segmentedIterator& operator-=(ItDiff offset) {
+        return *this += -offset;
+    }
+
+    segmentedIterator operator+ (ItDiff offset) const {
+        segmentedIterator it = *this;
+        return it += offset;
+    }
+
+    segmentedIterator operator- (ItDiff offset) const {
+        segmentedIterator it = *this;
+        return it += -offset;
+    }
+
+    ItDiff operator- (const segmentedIterator& it) const {
+        Check(it);
+        return ItDiff(pos) - it.pos;
+    }
+
+private:
+    void Check(const segmentedIterator& it) const {
+        if constexpr (checked_access) {
+            if (&head != &it.head) throw NotComparableIterators();
+        }
+    }
+
+    Pointer* const& map;
+    const SizeType& head;
+    const SizeType& size;
+    SizeType pos;
+};
+
+template <typename ValueType, size_t ChunkSize>
+class constSegmentedIterator : public ConstRandomAccessIterator<ValueType> {
+public:
+    using Base              = ConstRandomAccessIterator<ValueType>;
+    using Pointer           = typename Base::Pointer;
+    using ConstPointer      = typename Base::ConstPointer;
+    using Reference         = typename Base::Reference;
+    using ConstReference    = typename Base::ConstReference;
+    using ItDiff            = typename Base::ItDiff;
+    using SizeType          = typename Base::SizeType;
+
+    template <std::default_initializable VT, TAllocator AllocatorType, size_t CS> requires (std::has_single_bit(CS))
+    friend class SegmentedArray;
+
+private:
+    constSegmentedIterator(Pointer* const& map, const SizeType& head, const SizeType& size, SizeType pos) : map(map), head(head), size(size), pos(pos) {}
+
+public:
+
+    bool operator==(const constSegmentedIterator& it) const noexcept {
+        if constexpr (checked_access) {
+            return &head == &it.head && pos == it.pos;
+        } else {
+            return pos == it.pos;
+        }
+    }
+
+    bool operator!=(const constSegmentedIterator& it) const noexcept {
+        return !(*this == it);
+    }
+
+    bool operator>(const constSegmentedIterator& it) const {
+        Check(it);
+        return pos > it.pos;
+    }
+
+    bool operator<(const constSegmentedIterator& it) const {
+        Check(it);
+        return pos < it.pos;
+    }
+
+    bool operator>=(const constSegmentedIterator& it) const {
+        Check(it);
+        return pos >= it.pos;
+    }
+
+    bool operator<=(const constSegmentedIterator& it) const {
+        Check(it);
+        return pos <= it.pos;
+    }
+
+    ConstReference operator*() const {
+        if constexpr (checked_access) {
+            if (pos >= size) throw UndereferencableIterator();
+        }
+        SizeType ind = head + pos;
+        return map[ind / ChunkSize][ind % ChunkSize];
+    }
+
+    ConstPointer operator->() const {
+        return &**this;
+    }
+
+    constSegmentedIterator& operator++() {
+        if constexpr (checked_access) {
+            if (pos >= size) throw IteratorOutOfBounds();
+        }
+        ++pos;
+        return *this;
+    }
+
+    constSegmentedIterator operator++(int) {
+        constSegmentedIterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    constSegmentedIterator& operator--() {
+        if constexpr (checked_access) {
+            if (pos == 0) throw IteratorOutOfBounds();
+        }
+        --pos;
+        return *this;
+    }
+
+    constSegmentedIterator operator--(int) {
+        constSegmentedIterator it = *this;
+        --*this;
+        return it;
+    }
+
+    constSegmentedIterator& operator+=(ItDiff offset) {
+        if constexpr (checked_access) {
+            if (pos + offset > size) throw IteratorOutOfBounds();
+        }
+        pos += offset;
+        return *this;
+    }
+
+    constSegmentedIterator& operator-=(ItDiff offset) {
+        return *this += -offset;
+    }
+
+    constSegmentedIterator operator+ (ItDiff offset) const {
+        constSegmentedIterator it = *this;
+        return it += offset;
+    }
+
+    constSegmentedIterator operator- (ItDiff offset) const {
+        constSegmentedIterator it = *this;
+        return it += -offset;
+    }
+
+    ItDiff operator- (const constSegmentedIterator& it) const {
+        Check(it);
+        return ItDiff(pos) - it.pos;
+    }
+
+private:
+    void Check(const constSegmentedIterator& it) const {
+        if constexpr (checked_access) {
+            if (&head != &it.head) throw NotComparableIterators();
+        }
+    }
+
+    Pointer* const& map;
+    const SizeType& head;
+    const SizeType& size;
+    SizeType pos;
+};
+
+// Deque made of fixed chunks of ChunkSize elements listed in a table: element i lives
+// at chunk (head + i) / ChunkSize, so access is a shift and a mask away. Elements are
+// never moved once constructed, so references to them stay valid until they are
+// removed; growing at either end only allocates a chunk or, rarely, recenters the
+// table of chunk pointers. Iterators are positions, push_front shifts what they see.
+template <std::default_initializable VType,
+            TAllocator AlType = Allocator<VType>,
+            size_t ChunkSize = default_chunk_size<VType>> requires (std::has_single_bit(ChunkSize))
+class SegmentedArray {
+
+public:
+    using ValueType             = VType;
+    using Pointer               = ValueType*;
+    using Reference             = ValueType&;
+    using ConstPointer          = const ValueType*;
+    using ConstReference        = const ValueType&;
+    using AllocatorType         = AlType;
+    using Iterator              = segmentedIterator<ValueType, ChunkSize>;
+    using ConstIterator         = constSegmentedIterator<ValueType, ChunkSize>;
+    using SizeType              = typename Iterator::SizeType;
+    using ItDiff                = typename Iterator::ItDiff;
+
+    static constexpr SizeType chunk_size = ChunkSize;
+
+private:
+    using AllocTraits       = AllocatorTraits<ValueType, AllocatorType>;
+    using MapAlloc          = typename AllocatorType::RebindAlloc<Pointer>;
+    using MapAllocTraits    = AllocatorTraits<Pointer, MapAlloc>;
+
+public:
+
+    SegmentedArray() : map(nullptr), spare(nullptr), map_cap(0), head(0), _size(0), alloc(), map_alloc() {}
+
+    SegmentedArray(const std::initializer_list<ValueType>& list) : SegmentedArray() {
+        for (auto it = list.begin(); it != list.end(); ++it) {
+            emplace_back(*it);
+        }
+    }
+
+    SegmentedArray(const SegmentedArray& other) : SegmentedArray() {
+        for (auto it = other.cbegin(); it != other.cend(); ++it) {
+            emplace_back(*it);
+        }
+    }
+
+    SegmentedArray(SegmentedArray&& other) : SegmentedArray() {
+        Swap(other);
+    }
+
+    ~SegmentedArray() {
+        clear();
+        if (spare) AllocTraits::deallocate(alloc, spare, ChunkSize);
+        if (map) MapAllocTraits::deallocate(map_alloc, map, map_cap);
+    }
+
+    void operator=(const SegmentedArray& other) {
+        if (this == &other) return;
+        SegmentedArray copy(other);
+        Swap(copy);
+    }
+
+    void operator=(SegmentedArray&& other) {
+        SegmentedArray moved(std::move(other));
+        Swap(moved);
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(map, head, _size, 0);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return ConstIterator(map, head, _size, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(map, head, _size, _size);
+    }
+
+    ConstIterator cend() const noexcept {
+        return ConstIterator(map, head, _size, _size);
+    }
+
+    SizeType size() const noexcept {
+        return _size;
+    }
+
+    // index taken modulo size, negative indices count from the end
+    ValueType& at(ItDiff ind) noexcept {
+        if (ind >= 0) {
+            return Element(ind % _size);
+        } else {
+            return Element((_size + ind % ItDiff(_size)) % _size);
+        }
+    }
+
+    // wraps like at() in checked mode, plain offset in unchecked mode
+    ValueType& operator[](ItDiff ind) noexcept {
+        if constexpr (checked_access) {
+            return at(ind);
+        } else {
+            return Element(ind);
+        }
+    }
+
+    Reference front() {
+        if (_size == 0) throw UndereferencableIterator();
+        return Element(0);
+    }
+
+    Reference back() {
+        if (_size == 0) throw UndereferencableIterator();
+        return Element(_size - 1);
+    }
+
+    template <typename... Args> requires std::constructible_from<ValueType, Args...>
+    Reference emplace_back(Args&&... args) {
+        SizeType ind = head + _size;
+        if (ind / ChunkSize >= map_cap) {
+            Recenter();
+            ind = head + _size;
+        }
+        Pointer chunk = Acquire(ind / ChunkSize);
+        AllocTraits::construct(alloc, chunk + ind % ChunkSize, std::forward<Args>(args)...);
+        ++_size;
+        return chunk[ind % ChunkSize];
+    }
+
+    template <typename... Args> requires std::constructible_from<ValueType, Args...>
+    Reference emplace_front(Args&&... args) {
+        if (head == 0) Recenter();
+        SizeType ind = head - 1;
+        Pointer chunk = Acquire(ind / ChunkSize);
+        AllocTraits::construct(alloc, chunk + ind % ChunkSize, std::forward<Args>(args)...);
+        head = ind;
+        ++_size;
+        return chunk[ind % ChunkSize];
+    }
+
+    void push_back(const ValueType& val) {
+        emplace_back(val);
+    }
+
+    void push_back(ValueType&& val) {
+        emplace_back(std::move(val));
+    }
+
+    void push_front(const ValueType& val) {
+        emplace_front(val);
+    }
+
+    void push_front(ValueType&& val) {
+        emplace_front(std::move(val));
+    }
+
+    void pop_back() {
+        if (_size == 0) throw NothingToErase();
+        --_size;
+        SizeType ind = head + _size;
+        AllocTraits::destroy(alloc, &Element(_size));
+        if (ind % ChunkSize == 0) Release(ind / ChunkSize);
+    }
+
+    void pop_front() {
+        if (_size == 0) throw NothingToErase();
+        AllocTraits::destroy(alloc, &Element(0));
+        ++head;
+        --_size;
+        if (head % ChunkSize == 0) Release(head / ChunkSize - 1);
+    }
+
+    void clear() {
+        while (_size != 0) {
+            AllocTraits::destroy(alloc, &Element(--_size));
+        }
+        for (SizeType i = 0; i < map_cap; ++i) {
+            if (map[i]) Release(i);
+        }
+        head = map_cap / 2 * ChunkSize;
+    }
+
+private:
+    Reference Element(SizeType ind) const noexcept {
+        ind += head;
+        return map[ind / ChunkSize][ind % ChunkSize];
+    }
+
+    // the chunk at table slot i, allocated (or taken from the spare) when missing
+    Pointer Acquire(SizeType i) {
+        if (!map[i]) {
+            if (spare) {
+                map[i] = spare;
+                spare = nullptr;
+            } else {
+                map[i] = AllocTraits::allocate(alloc, ChunkSize);
+            }
+        }
+        return map[i];
+    }
+
+    // one emptied chunk is kept, so pushing and popping across a chunk border doesn't allocate
+    void Release(SizeType i) {
+        if (spare) AllocTraits::deallocate(alloc, map[i], ChunkSize);
+        else spare = map[i];
+        map[i] = nullptr;
+    }
+
+    // moves the chunks in use to the middle of the table, doubling it if that leaves
+    // less than a free slot on either side; only the chunk pointers move
+    void Recenter() {
+        SizeType first = head / ChunkSize;
+        SizeType used = (_size == 0 ? 0 : (head + _size - 1) / ChunkSize - first + 1);
+        if (_size == 0 && first < map_cap && map[first]) used = 1;
+        SizeType new_cap = map_cap;
+        if (used + 2 > map_cap / 2) new_cap = std::max<SizeType>(8, 2*(used + 2));
+        SizeType new_first = (new_cap - used) / 2;
+        if (new_cap == map_cap) {
+            if (new_first < first) std::copy(map + first, map + first + used, map + new_first);
+            else std::copy_backward(map + first, map + first + used, map + new_first + used);
+            std::fill(map, map + new_first, nullptr);
+            std::fill(map + new_first + used, map + map_cap, nullptr);
+        } else {
+            Pointer* new_map = MapAllocTraits::allocate(map_alloc, new_cap);
+            std::fill(new_map, new_map + new_cap, nullptr);
+            if (map) {
+                std::copy(map + first, map + first + used, new_map + new_first);
+                MapAllocTraits::deallocate(map_alloc, map, map_cap);
+            }
+            map = new_map;
+            map_cap = new_cap;
+        }
+        head = new_first * ChunkSize + head % ChunkSize;
+    }
+
+    void Swap(SegmentedArray& other) {
+        std::swap(map, other.map);
+        std::swap(spare, other.spare);
+        std::swap(map_cap, other.map_cap);
+        std::swap(head, other.head);
+        std::swap(_size, other._size);
+        std::swap(alloc, other.alloc);
+        std::swap(map_alloc, other.map_alloc);
+    }
+
+    Pointer* map;
+    Pointer spare;
+    SizeType map_cap, head, _size;
+    AllocatorType alloc;
+    MapAlloc map_alloc;
+};
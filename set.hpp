@@ -1,3 +1,5 @@
+#pragma once
+
 #include "rbtree.hpp"
 
 template <class T>
@@ -28,7 +30,7 @@ public:
     Set() : Base() {}
     Set(const std::initializer_list<KeyType>& list) : Base(list) {}
     template <IsForwardIterator<KeyType> Iter>
-    Set(Iterator first, Iterator last) : Base(first, last) {}
+    Set(Iter first, Iter last) : Base(first, last) {}
 
     SizeType count(const KeyType& key) const noexcept = delete;
 
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <concepts>
+#include <type_traits>
+
+// Width of the vector registers the kernels are compiled for: 32 bytes with AVX2,
+// 16 with SSE2 (or any other target GCC/Clang can vectorize for), 0 means scalar only.
+#if defined(__GNUC__) && defined(__AVX2__)
+inline constexpr size_t simd_width = 32;
+#elif defined(__GNUC__) && (defined(__SSE2__) || defined(__ARM_NEON))
+inline constexpr size_t simd_width = 16;
+#else
+inline constexpr size_t simd_width = 0;
+#endif
+
+template <typename T, bool Enable>
+struct SimdVector {
+    using Vec = T;
+    using Mask = T;
+};
+
+#if defined(__GNUC__)
+template <typename T>
+struct SimdVector<T, true> {
+    typedef T Vec __attribute__((vector_size(simd_width)));
+    using Mask = decltype(Vec() == Vec());
+};
+#endif
+
+template <typename T>
+concept SimdArithmetic = (std::integral<T> && !std::same_as<T, bool>) || std::same_as<T, float> || std::same_as<T, double>;
+
+// Search, comparison, fill and reduction kernels over contiguous ranges. For integral
+// and floating-point types they process simd_width bytes per step using the compiler's
+// vector types, so -mavx2 / -msse2 pick the instruction set at compile time; every other
+// type (and a build without vector support) takes the scalar loops.
+// Floating-point sums are reassociated and may differ from a left-to-right sum in the last bits.
+template <typename T>
+class SimdKernels {
+public:
+    static constexpr bool vectorized = simd_width != 0 && SimdArithmetic<T>;
+
+    // index of the first element equal to val, n if there is none
+    static size_t find(const T* data, size_t n, const T& val) noexcept {
+        size_t i = 0;
+        if constexpr (vectorized) {
+            Vec key = Splat(val);
+            for (; i + lanes <= n; i += lanes) {
+                if (Any(Load(data + i) == key)) break;
+            }
+        }
+        for (; i < n; ++i) {
+            if (data[i] == val) return i;
+        }
+        return n;
+    }
+
+    static size_t count(const T* data, size_t n, const T& val) noexcept {
+        size_t i = 0, cnt = 0;
+        if constexpr (vectorized) {
+            // matching lanes are -1, so subtracting masks counts them; flush before lanes overflow
+            constexpr size_t flush = (sizeof(T) == 1 ? 127 : sizeof(T) == 2 ? 32767 : size_t(1) << 30);
+            Vec key = Splat(val);
+            while (i + lanes <= n) {
+                Mask acc = {};
+                for (size_t k = 0; k < flush && i + lanes <= n; ++k, i += lanes) {
+                    acc -= (Load(data + i) == key);
+                }
+                for (size_t l = 0; l < lanes; ++l) cnt += static_cast<size_t>(acc[l]);
+            }
+        }
+        for (; i < n; ++i) {
+            if (data[i] == val) ++cnt;
+        }
+        return cnt;
+    }
+
+    static bool equal(const T* a, const T* b, size_t n) noexcept {
+        size_t i = 0;
+        if constexpr (vectorized) {
+            for (; i + lanes <= n; i += lanes) {
+                if (Any(Load(a + i) != Load(b + i))) return false;
+            }
+        }
+        for (; i < n; ++i) {
+            if (!(a[i] == b[i])) return false;
+        }
+        return true;
+    }
+
+    static void fill(T* data, size_t n, const T& val) {
+        size_t i = 0;
+        if constexpr (vectorized) {
+            Vec v = Splat(val);
+            for (; i + lanes <= n; i += lanes) {
+                std::memcpy(data + i, &v, sizeof(Vec));
+            }
+        }
+        for (; i < n; ++i) {
+            data[i] = val;
+        }
+    }
+
+    // n must be positive
+    static T min(const T* data, size_t n) noexcept {
+        T res = data[0];
+        size_t i = 0;
+        if constexpr (vectorized) {
+            if (n >= lanes) {
+                Vec m = Load(data);
+                for (i = lanes; i + lanes <= n; i += lanes) {
+                    Vec v = Load(data + i);
+                    m = (v < m ? v : m);
+                }
+                for (size_t l = 0; l < lanes; ++l) {
+                    if (m[l] < res) res = m[l];
+                }
+            }
+        }
+        for (; i < n; ++i) {
+            if (data[i] < res) res = data[i];
+        }
+        return res;
+    }
+
+    // n must be positive
+    static T max(const T* data, size_t n) noexcept {
+        T res = data[0];
+        size_t i = 0;
+        if constexpr (vectorized) {
+            if (n >= lanes) {
+                Vec m = Load(data);
+                for (i = lanes; i + lanes <= n; i += lanes) {
+                    Vec v = Load(data + i);
+                    m = (m < v ? v : m);
+                }
+                for (size_t l = 0; l < lanes; ++l) {
+                    if (res < m[l]) res = m[l];
+                }
+            }
+        }
+        for (; i < n; ++i) {
+            if (res < data[i]) res = data[i];
+        }
+        return res;
+    }
+
+    static T sum(const T* data, size_t n) noexcept {
+        if constexpr (vectorized && std::signed_integral<T>) {
+            // lanes wrap around like the scalar sum does, but signed overflow in a lane is undefined
+            using U = std::make_unsigned_t<T>;
+            return static_cast<T>(SimdKernels<U>::sum(reinterpret_cast<const U*>(data), n));
+        }
+        T res = T();
+        size_t i = 0;
+        if constexpr (vectorized) {
+            Vec acc = {};
+            for (; i + lanes <= n; i += lanes) {
+                acc += Load(data + i);
+            }
+            for (size_t l = 0; l < lanes; ++l) res += acc[l];
+        }
+        for (; i < n; ++i) {
+            res += data[i];
+        }
+        return res;
+    }
+
+private:
+    static constexpr size_t lanes = (vectorized ? simd_width / sizeof(T) : 1);
+
+    using Vec = typename SimdVector<T, vectorized>::Vec;
+    using Mask = typename SimdVector<T, vectorized>::Mask;
+
+    static Vec Load(const T* ptr) noexcept {
+        Vec v;
+        std::memcpy(&v, ptr, sizeof(Vec));
+        return v;
+    }
+
+    static Vec Splat(const T& val) noexcept {
+        Vec v;
+        for (size_t l = 0; l < lanes; ++l) v[l] = val;
+        return v;
+    }
+
+    static bool Any(const Mask& mask) noexcept {
+        unsigned long long words[sizeof(Mask) / 8 ? sizeof(Mask) / 8 : 1] = {};
+        std::memcpy(words, &mask, sizeof(Mask));
+        unsigned long long res = 0;
+        for (auto word : words) res |= word;
+        return res != 0;
+    }
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "exceptions.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <concepts>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+// Binary snapshots written by save() and read by load() of the containers: a header
+// (magic, format version, container kind, element size, element count) followed by
+// the elements. Numbers are stored in the byte order of the machine that saved them.
+enum class SnapshotKind : uint32_t {
+    Array = 1, List = 2, Tree = 3
+};
+
+struct SnapshotHeader {
+    static constexpr char magic_bytes[4] = {'C', 'P', 'L', 'S'};
+    static constexpr uint32_t current_version = 1;
+
+    char magic[4];
+    uint32_t version;
+    SnapshotKind kind;
+    uint32_t value_size;    // sizeof of raw elements, 0 for elements with their own save/load
+    uint64_t count;
+
+    static void write(std::ostream& out, SnapshotKind kind, uint32_t value_size, uint64_t count) {
+        SnapshotHeader header;
+        std::memcpy(header.magic, magic_bytes, sizeof(magic));
+        header.version = current_version;
+        header.kind = kind;
+        header.value_size = value_size;
+        header.count = count;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!out) throw SnapshotError();
+    }
+
+    // count of elements that follow, after checking the header matches what's expected
+    static uint64_t read(std::istream& in, SnapshotKind kind, uint32_t value_size) {
+        SnapshotHeader header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || std::memcmp(header.magic, magic_bytes, sizeof(magic)) != 0
+                || header.version != current_version || header.kind != kind || header.value_size != value_size) {
+            throw SnapshotError();
+        }
+        return header.count;
+    }
+};
+
+// How much room to reserve for count elements of value_size bytes (0 for elements with
+// their own save/load) announced by a header, which may be corrupt. A seekable stream too
+// short to hold count raw elements is rejected right away; otherwise the count is trusted
+// only up to a chunk, and the container grows as the elements actually arrive.
+inline constexpr uint64_t snapshot_chunk = uint64_t(1) << 16;
+
+inline uint64_t snapshot_reserve(std::istream& in, uint64_t count, uint32_t value_size) {
+    std::streambuf* buf = in.rdbuf();
+    std::streamoff pos = (buf ? std::streamoff(buf->pubseekoff(0, std::ios::cur, std::ios::in)) : -1);
+    if (value_size == 0 || pos < 0) return std::min(count, snapshot_chunk);
+    std::streamoff end = buf->pubseekoff(0, std::ios::end, std::ios::in);
+    buf->pubseekpos(pos, std::ios::in);
+    if (end < pos) return std::min(count, snapshot_chunk);
+    if (count > uint64_t(end - pos) / value_size) throw SnapshotError();
+    return count;
+}
+
+// How elements are stored: trivially copyable ones as raw bytes, so contiguous runs of
+// them take one read or write; others through their own save(ostream)/load(istream),
+// which the containers themselves have, so nested containers work too. Specialize it
+// for other types.
+template <typename T>
+struct Serializer;
+
+template <typename T> requires std::is_trivially_copyable_v<T>
+struct Serializer<T> {
+    static constexpr bool raw = true;
+
+    static void write(std::ostream& out, const T* data, size_t n) {
+        out.write(reinterpret_cast<const char*>(data), n*sizeof(T));
+        if (!out) throw SnapshotError();
+    }
+
+    static void read(std::istream& in, T* data, size_t n) {
+        in.read(reinterpret_cast<char*>(data), n*sizeof(T));
+        if (!in) throw SnapshotError();
+    }
+};
+
+template <typename T> requires (!std::is_trivially_copyable_v<T>)
+    && requires (const T& c, T& v, std::ostream& out, std::istream& in) { c.save(out); v.load(in); }
+struct Serializer<T> {
+    static constexpr bool raw = false;
+
+    static void write(std::ostream& out, const T* data, size_t n) {
+        for (size_t i = 0; i < n; ++i) data[i].save(out);
+    }
+
+    static void read(std::istream& in, T* data, size_t n) {
+        for (size_t i = 0; i < n; ++i) data[i].load(in);
+    }
+};
+
+template <typename T>
+concept Serializable = requires (std::ostream& out, std::istream& in, T* data) {
+    Serializer<T>::write(out, data, size_t());
+    Serializer<T>::read(in, data, size_t());
+};
+
+template <Serializable T>
+inline constexpr uint32_t snapshot_value_size = (Serializer<T>::raw ? sizeof(T) : 0);
+
+// Element I/O for containers that aren't contiguous: raw elements go through a small
+// buffer, so they are still written and read in blocks rather than one by one.
+template <typename T> requires Serializable<T> && std::default_initializable<T>
+struct SnapshotBuffer {
+    static constexpr size_t capacity = (sizeof(T) < 4096 ? 4096 / sizeof(T) : 1);
+
+    template <typename It>
+    static void write(std::ostream& out, It first, It last) {
+        if constexpr (Serializer<T>::raw) {
+            T buf[capacity];
+            size_t k = 0;
+            for (; first != last; ++first) {
+                buf[k++] = *first;
+                if (k == capacity) {
+                    Serializer<T>::write(out, buf, k);
+                    k = 0;
+                }
+            }
+            if (k != 0) Serializer<T>::write(out, buf, k);
+        } else {
+            for (; first != last; ++first) Serializer<T>::write(out, &*first, 1);
+        }
+    }
+
+    // reads n elements and hands each to put(T&&), in order
+    template <typename F>
+    static void read(std::istream& in, uint64_t n, F put) {
+        if constexpr (Serializer<T>::raw) {
+            T buf[capacity];
+            while (n != 0) {
+                size_t k = (n < capacity ? n : capacity);
+                Serializer<T>::read(in, buf, k);
+                for (size_t i = 0; i < k; ++i) put(std::move(buf[i]));
+                n -= k;
+            }
+        } else {
+            for (; n != 0; --n) {
+                T val;
+                Serializer<T>::read(in, &val, 1);
+                put(std::move(val));
+            }
+        }
+    }
+};
@@ -0,0 +1,263 @@
+#pragma once
+
+#include "array.hpp"
+#include <new>
+#include <tuple>
+#include <utility>
+
+// Array of records stored field by field: every field has its own contiguous column,
+// so a loop over one or two fields reads only those. The columns share one capacity
+// and growth policy and are allocated by AlType rebound to each field type (64-byte
+// aligned by default, so the vector kernels start on a cache line). operator[] gives a
+// row as a tuple of references; column<I>() gives a Slice over field I, which runs the
+// vectorized search and reductions, and begin<I>()/end<I>() iterate one column.
+template <TAllocator AlType, GrowthPolicy GrType, std::default_initializable... Fields> requires (sizeof...(Fields) > 0)
+class BasicSoAArray {
+
+public:
+    using AllocatorType         = AlType;
+    using GrowthType            = GrType;
+    using SizeType              = size_t;
+    using Row                   = std::tuple<Fields&...>;
+    using ConstRow              = std::tuple<const Fields&...>;
+
+    template <size_t I>
+    using FieldType             = std::tuple_element_t<I, std::tuple<Fields...>>;
+    template <size_t I>
+    using Iterator              = arrayIterator<FieldType<I>>;
+    template <size_t I>
+    using ConstIterator         = constArrayIterator<FieldType<I>>;
+    template <size_t I>
+    using SliceType             = Slice<FieldType<I>>;
+    using ItDiff                = typename Iterator<0>::ItDiff;
+
+    static constexpr size_t field_count = sizeof...(Fields);
+
+private:
+    template <typename T>
+    using FieldAlloc        = typename AllocatorType::template RebindAlloc<T>;
+
+    template <size_t I>
+    using FieldTraits       = AllocatorTraits<FieldType<I>, FieldAlloc<FieldType<I>>>;
+
+    using Indices           = std::index_sequence_for<Fields...>;
+
+public:
+
+    BasicSoAArray() : _size(0), cap(0), columns(), allocs() {}
+
+    BasicSoAArray(const BasicSoAArray& other) : BasicSoAArray() {
+        reserve(other._size);
+        for (SizeType i = 0; i < other._size; ++i) {
+            std::apply([this](const Fields&... vals) { emplace_back(vals...); }, other.Get(i, Indices()));
+        }
+    }
+
+    BasicSoAArray(BasicSoAArray&& other) : BasicSoAArray() {
+        Swap(other);
+    }
+
+    ~BasicSoAArray() {
+        Destroy(Indices());
+    }
+
+    void operator=(const BasicSoAArray& other) {
+        if (this == &other) return;
+        BasicSoAArray copy(other);
+        Swap(copy);
+    }
+
+    void operator=(BasicSoAArray&& other) {
+        BasicSoAArray moved(std::move(other));
+        Swap(moved);
+    }
+
+    SizeType size() const noexcept {
+        return _size;
+    }
+
+    SizeType capacity() const noexcept {
+        return cap;
+    }
+
+    void reserve(SizeType n) {
+        if (n > cap) Reallocate(n, Indices());
+    }
+
+    template <typename... Args> requires (sizeof...(Args) == sizeof...(Fields))
+    Row emplace_back(Args&&... args) {
+        if (_size == cap) Reallocate(GrowthType::next(cap, _size + 1), Indices());
+        Construct(Indices(), std::forward<Args>(args)...);
+        ++_size;
+        return Get(_size - 1, Indices());
+    }
+
+    void append(const Fields&... vals) {
+        emplace_back(vals...);
+    }
+
+    void pop() {
+        if (_size == 0) throw NothingToErase();
+        --_size;
+        DestroyRow(_size, Indices());
+    }
+
+    void clear() {
+        while (_size != 0) {
+            --_size;
+            DestroyRow(_size, Indices());
+        }
+    }
+
+    // index taken modulo size, negative indices count from the end
+    Row at(ItDiff ind) noexcept {
+        if (ind >= 0) {
+            return Get(ind % _size, Indices());
+        } else {
+            return Get((_size + ind % ItDiff(_size)) % _size, Indices());
+        }
+    }
+
+    // wraps like at() in checked mode, plain offset in unchecked mode
+    Row operator[](ItDiff ind) noexcept {
+        if constexpr (checked_access) {
+            return at(ind);
+        } else {
+            return Get(ind, Indices());
+        }
+    }
+
+    ConstRow operator[](ItDiff ind) const noexcept {
+        return const_cast<BasicSoAArray&>(*this)[ind];
+    }
+
+    template <size_t I>
+    SliceType<I> column() noexcept {
+        return SliceType<I>(std::get<I>(columns), _size);
+    }
+
+    // column iterators follow the array when it grows, as Array's do
+    template <size_t I>
+    Iterator<I> begin() noexcept {
+        return Iterator<I>(std::get<I>(columns), _size, 0);
+    }
+
+    template <size_t I>
+    ConstIterator<I> cbegin() const noexcept {
+        return ConstIterator<I>(std::get<I>(columns), _size, 0);
+    }
+
+    template <size_t I>
+    Iterator<I> end() noexcept {
+        return Iterator<I>(std::get<I>(columns), _size, _size);
+    }
+
+    template <size_t I>
+    ConstIterator<I> cend() const noexcept {
+        return ConstIterator<I>(std::get<I>(columns), _size, _size);
+    }
+
+private:
+    template <size_t... I>
+    Row Get(SizeType ind, std::index_sequence<I...>) const noexcept {
+        return Row(std::get<I>(columns)[ind]...);
+    }
+
+    template <size_t... I, typename... Args>
+    void Construct(std::index_sequence<I...>, Args&&... args) {
+        // a throwing field constructor unwinds the fields of the row constructed before it
+        SizeType done = 0;
+        try {
+            ((FieldTraits<I>::construct(std::get<I>(allocs), std::get<I>(columns) + _size, std::forward<Args>(args)), ++done), ...);
+        } catch (...) {
+            ((I < done ? FieldTraits<I>::destroy(std::get<I>(allocs), std::get<I>(columns) + _size) : void()), ...);
+            throw;
+        }
+    }
+
+    template <size_t... I>
+    void DestroyRow(SizeType ind, std::index_sequence<I...>) {
+        (FieldTraits<I>::destroy(std::get<I>(allocs), std::get<I>(columns) + ind), ...);
+    }
+
+    // columns whose elements can be moved without throwing; the others are copied (or
+    // moved, if they can't be copied) into the new buffers before anything is committed
+    template <size_t I>
+    static constexpr bool relocates = is_trivially_relocatable<FieldType<I>> || std::is_nothrow_move_constructible_v<FieldType<I>>;
+
+    // all new columns are allocated and filled before any old one is touched, so if an
+    // allocation or a copy throws the new buffers are unwound and the array stays as it was
+    template <size_t... I>
+    void Reallocate(SizeType n, std::index_sequence<I...>) {
+        std::tuple<Fields*...> fresh{};
+        SizeType allocated = 0, filled = 0;
+        try {
+            ((std::get<I>(fresh) = Allocate<I>(n), ++allocated), ...);
+            ((Fill<I>(std::get<I>(fresh)), ++filled), ...);
+        } catch (...) {
+            ((I < filled && !relocates<I> ? DestroyColumn<I>(std::get<I>(fresh), _size) : void()), ...);
+            ((I < allocated ? FieldTraits<I>::deallocate(std::get<I>(allocs), std::get<I>(fresh), n) : void()), ...);
+            throw;
+        }
+        (Commit<I>(std::get<I>(fresh)), ...);
+        cap = n;
+    }
+
+    template <size_t I>
+    FieldType<I>* Allocate(SizeType n) {
+        FieldType<I>* column = FieldTraits<I>::allocate(std::get<I>(allocs), n);
+        if (!column) throw std::bad_alloc();
+        return column;
+    }
+
+    template <size_t I>
+    void Fill(FieldType<I>* column) {
+        if constexpr (!relocates<I>) {
+            SizeType i = 0;
+            try {
+                for (; i < _size; ++i) {
+                    FieldTraits<I>::construct(std::get<I>(allocs), column + i, std::move_if_noexcept(std::get<I>(columns)[i]));
+                }
+            } catch (...) {
+                DestroyColumn<I>(column, i);
+                throw;
+            }
+        }
+    }
+
+    template <size_t I>
+    void DestroyColumn(FieldType<I>* column, SizeType n) {
+        for (SizeType i = 0; i < n; ++i) FieldTraits<I>::destroy(std::get<I>(allocs), column + i);
+    }
+
+    template <size_t I>
+    void Commit(FieldType<I>* column) {
+        if constexpr (relocates<I>) {
+            FieldTraits<I>::relocate(std::get<I>(allocs), column, std::get<I>(columns), _size);
+        } else {
+            DestroyColumn<I>(std::get<I>(columns), _size);
+        }
+        FieldTraits<I>::deallocate(std::get<I>(allocs), std::get<I>(columns), cap);
+        std::get<I>(columns) = column;
+    }
+
+    template <size_t... I>
+    void Destroy(std::index_sequence<I...>) {
+        clear();
+        (FieldTraits<I>::deallocate(std::get<I>(allocs), std::get<I>(columns), cap), ...);
+    }
+
+    void Swap(BasicSoAArray& other) {
+        std::swap(_size, other._size);
+        std::swap(cap, other.cap);
+        std::swap(columns, other.columns);
+        std::swap(allocs, other.allocs);
+    }
+
+    SizeType _size, cap;
+    std::tuple<Fields*...> columns;
+    std::tuple<FieldAlloc<Fields>...> allocs;
+};
+
+template <std::default_initializable... Fields>
+using SoAArray = BasicSoAArray<AlignedAllocator<char>, DoubleGrowth, Fields...>;